@@ -0,0 +1,421 @@
+/*
+ B+ Tree Class
+ This class keeps values ordered by an unsigned 32 bit key (ie. a packed Date) and answers range queries.
+ Every value lives in a leaf, and the leaves are linked in key order in both directions, so a range is read by finding its first entry and walking the leaves from there. Internal (branch) nodes only hold separator keys and child pointers.
+ Nodes are wide (64 entries) and store their keys in one contiguous array, so finding the way through a node touches a few cache lines and the tree stays only a few levels deep even for millions of entries.
+ Any number of values may share a key. Removing a value takes it out of its leaf without rebalancing the tree: leaves may run below half full (or even empty), which keeps removal to a single shift within one leaf. Range walks simply step over empty leaves.
+ Values are stored as given, so the tree is meant to hold small handles (ie. pointers into another structure).
+ */
+
+#ifndef BPlusTree_h
+#define BPlusTree_h
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <typename V>
+class BPlusTree
+{
+private:
+    static const int LEAF_CAPACITY = 64; // entries per leaf
+    static const int BRANCH_CAPACITY = 64; // children per branch (one separator key fewer)
+
+    struct Leaf
+    {
+        int size = 0;
+        std::uint32_t keys[LEAF_CAPACITY];
+        V values[LEAF_CAPACITY];
+        Leaf *previous = nullptr, *next = nullptr; // neighbouring leaves in key order
+    };
+
+    struct Branch
+    {
+        int size = 0; // number of children
+        std::uint32_t keys[BRANCH_CAPACITY - 1]; // keys[i] separates children[i] (keys <= it) from children[i + 1] (keys >= it)
+        void *children[BRANCH_CAPACITY]; // branches above the leaf level, leaves at it
+    };
+
+    void *root; // a leaf while height is 0, otherwise a branch
+    int height = 0; // branch levels above the leaves
+    int count = 0, leafCount = 1, branchCount = 0;
+    Leaf *firstLeaf, *lastLeaf; // ends of the leaf chain
+
+    /*
+     This method inserts into the subtree below the given node. If the node had to split, the new right hand node and the key separating it from the left one are handed back so the caller can link them in.
+     Pre: node, its level (0 for a leaf), key, value, separator and node to receive a split
+     Post: value stored in the subtree
+     Return: true if the node split
+     */
+    bool insertInto(void*, int, std::uint32_t, V&, std::uint32_t&, void*&);
+    bool insertIntoLeaf(Leaf*, std::uint32_t, V&, std::uint32_t&, void*&); // leaf level of insertInto
+    std::pair<Leaf*, int> lowerBound(std::uint32_t); // first entry with a key of at least the given one (leaf nullptr if there is none)
+    void destroy(void*, int); // deletes the subtree below the given node
+
+public:
+    BPlusTree(); // Constructor, empty tree
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    /*
+     This method adds a value under the given key, after any values already stored under the same key. A full leaf splits in two, and the split moves up through full branches, growing the tree by a level at the root if needed.
+     Pre: key, value
+     Post: value stored
+     Return: none
+     */
+    void insert(std::uint32_t, V);
+
+    /*
+     This method fills an empty tree from entries already sorted by key, building it from the leaves up instead of inserting one entry at a time. Leaves are packed full and every node is written once, so this is much faster than separate inserts for a large initial load. A tree that is not empty gets the entries inserted one by one instead.
+     Pre: (key, value) pairs in key order
+     Post: entries stored
+     Return: none
+     */
+    void build(const std::vector<std::pair<std::uint32_t, V>>&);
+
+    /*
+     This method removes one value stored under the given key.
+     Pre: key, value to remove (compared with ==)
+     Post: value removed if found
+     Return: true if removed
+     */
+    bool remove(std::uint32_t, const V&);
+
+    /*
+     This method calls the visitor on every value with a key between the two given keys (both included), in key order. The first entry is found in O(log n), and the walk along the leaves from there costs O(k) for k matches.
+     Pre: lowest key, highest key, function taking (std::uint32_t key, V&)
+     Post: visitor called once per value in the range
+     Return: number of values visited
+     */
+    template <typename Visitor>
+    int forEachInRange(std::uint32_t, std::uint32_t, Visitor);
+
+    /*
+     This method counts the values with a key between the two given keys (both included). Leaves that lie entirely inside the range are counted by their size, without looking at their entries.
+     Pre: lowest key, highest key
+     Post: none
+     Return: number of values in the range
+     */
+    int countInRange(std::uint32_t, std::uint32_t);
+
+    V* first(); // value with the smallest key (the first stored among equals), nullptr if empty
+    V* last(); // value with the largest key (the last stored among equals), nullptr if empty
+    int getCount(); // values stored
+    int getHeight(); // levels including the leaves
+    int getNodeCount(); // leaves and branches allocated
+
+    ~BPlusTree();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename V>
+BPlusTree<V>::BPlusTree()
+{
+    Leaf *leaf = new Leaf();
+    this->root = leaf;
+    this->firstLeaf = this->lastLeaf = leaf;
+}
+
+template <typename V>
+void BPlusTree<V>::insert(std::uint32_t key, V value)
+{
+    std::uint32_t separator;
+    void *right;
+    if (insertInto(this->root, this->height, key, value, separator, right)) // the root split, add a level above it
+    {
+        Branch *newRoot = new Branch();
+        newRoot->size = 2;
+        newRoot->keys[0] = separator;
+        newRoot->children[0] = this->root;
+        newRoot->children[1] = right;
+        this->root = newRoot;
+        this->height++;
+        this->branchCount++;
+    }
+    this->count++;
+}
+
+template <typename V>
+void BPlusTree<V>::build(const std::vector<std::pair<std::uint32_t, V>> &entries)
+{
+    if (this->count > 0 || entries.empty())
+    {
+        for (const std::pair<std::uint32_t, V> &entry : entries)
+            insert(entry.first, entry.second);
+        return;
+    }
+    destroy(this->root, this->height);
+    this->leafCount = this->branchCount = 0;
+    std::vector<void*> nodes; // the level being built
+    std::vector<std::uint32_t> firstKeys; // smallest key below each node of that level
+    std::size_t total = entries.size(), leaves = (total + LEAF_CAPACITY - 1) / LEAF_CAPACITY, next = 0;
+    Leaf *previous = nullptr;
+    for (std::size_t leafIndex = 0; leafIndex < leaves; leafIndex++) // entries spread evenly, so no leaf is left nearly empty
+    {
+        Leaf *leaf = new Leaf();
+        this->leafCount++;
+        std::size_t end = total * (leafIndex + 1) / leaves;
+        for (; next < end; next++, leaf->size++)
+        {
+            leaf->keys[leaf->size] = entries[next].first;
+            leaf->values[leaf->size] = entries[next].second;
+        }
+        leaf->previous = previous;
+        if (previous != nullptr)
+            previous->next = leaf;
+        previous = leaf;
+        nodes.push_back(leaf);
+        firstKeys.push_back(leaf->keys[0]);
+    }
+    this->firstLeaf = static_cast<Leaf*>(nodes.front());
+    this->lastLeaf = previous;
+    this->height = 0;
+    while (nodes.size() > 1) // group the level under branches until a single root is left
+    {
+        std::vector<void*> parents;
+        std::vector<std::uint32_t> parentKeys;
+        std::size_t branches = (nodes.size() + BRANCH_CAPACITY - 1) / BRANCH_CAPACITY, child = 0;
+        for (std::size_t branchIndex = 0; branchIndex < branches; branchIndex++)
+        {
+            Branch *branch = new Branch();
+            this->branchCount++;
+            parentKeys.push_back(firstKeys[child]);
+            std::size_t end = nodes.size() * (branchIndex + 1) / branches;
+            for (; child < end; child++, branch->size++)
+            {
+                if (branch->size > 0)
+                    branch->keys[branch->size - 1] = firstKeys[child];
+                branch->children[branch->size] = nodes[child];
+            }
+            parents.push_back(branch);
+        }
+        nodes.swap(parents);
+        firstKeys.swap(parentKeys);
+        this->height++;
+    }
+    this->root = nodes.front();
+    this->count = int(total);
+}
+
+template <typename V>
+bool BPlusTree<V>::remove(std::uint32_t key, const V &value)
+{
+    for (std::pair<Leaf*, int> position = lowerBound(key); position.first != nullptr; position.first = position.first->next, position.second = 0)
+    {
+        Leaf *leaf = position.first;
+        for (int index = position.second; index < leaf->size; index++)
+        {
+            if (leaf->keys[index] != key)
+                return false;
+            if (leaf->values[index] == value)
+            {
+                std::move(leaf->keys + index + 1, leaf->keys + leaf->size, leaf->keys + index);
+                std::move(leaf->values + index + 1, leaf->values + leaf->size, leaf->values + index);
+                leaf->size--;
+                this->count--;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename V>
+template <typename Visitor>
+int BPlusTree<V>::forEachInRange(std::uint32_t lowest, std::uint32_t highest, Visitor visit)
+{
+    int visited = 0;
+    for (std::pair<Leaf*, int> position = lowerBound(lowest); position.first != nullptr; position.first = position.first->next, position.second = 0)
+    {
+        Leaf *leaf = position.first;
+        for (int index = position.second; index < leaf->size; index++)
+        {
+            if (leaf->keys[index] > highest)
+                return visited;
+            visit(leaf->keys[index], leaf->values[index]);
+            visited++;
+        }
+    }
+    return visited;
+}
+
+template <typename V>
+int BPlusTree<V>::countInRange(std::uint32_t lowest, std::uint32_t highest)
+{
+    int counted = 0;
+    for (std::pair<Leaf*, int> position = lowerBound(lowest); position.first != nullptr; position.first = position.first->next, position.second = 0)
+    {
+        Leaf *leaf = position.first;
+        if (leaf->size == 0)
+            continue;
+        if (leaf->keys[leaf->size - 1] <= highest) // the rest of the leaf is inside the range
+        {
+            counted += leaf->size - position.second;
+            continue;
+        }
+        return counted + int(std::upper_bound(leaf->keys + position.second, leaf->keys + leaf->size, highest) - (leaf->keys + position.second));
+    }
+    return counted;
+}
+
+template <typename V>
+V* BPlusTree<V>::first()
+{
+    for (Leaf *leaf = this->firstLeaf; leaf != nullptr; leaf = leaf->next)
+        if (leaf->size > 0)
+            return &leaf->values[0];
+    return nullptr;
+}
+
+template <typename V>
+V* BPlusTree<V>::last()
+{
+    for (Leaf *leaf = this->lastLeaf; leaf != nullptr; leaf = leaf->previous)
+        if (leaf->size > 0)
+            return &leaf->values[leaf->size - 1];
+    return nullptr;
+}
+
+template <typename V>
+int BPlusTree<V>::getCount()
+{return this->count;}
+
+template <typename V>
+int BPlusTree<V>::getHeight()
+{return this->height + 1;}
+
+template <typename V>
+int BPlusTree<V>::getNodeCount()
+{return this->leafCount + this->branchCount;}
+
+template <typename V>
+BPlusTree<V>::~BPlusTree()
+{
+    destroy(this->root, this->height);
+}
+
+/*
+ Private Functions
+ */
+
+template <typename V>
+bool BPlusTree<V>::insertInto(void *node, int level, std::uint32_t key, V &value, std::uint32_t &separator, void *&right)
+{
+    if (level == 0)
+        return insertIntoLeaf(static_cast<Leaf*>(node), key, value, separator, right);
+
+    Branch *branch = static_cast<Branch*>(node);
+    int child = int(std::upper_bound(branch->keys, branch->keys + branch->size - 1, key) - branch->keys); // after every equal key
+    std::uint32_t childSeparator;
+    void *childRight;
+    if (!insertInto(branch->children[child], level - 1, key, value, childSeparator, childRight))
+        return false;
+
+    std::uint32_t keys[BRANCH_CAPACITY]; // the branch's keys and children with the new child linked in, one more than fits
+    void *children[BRANCH_CAPACITY + 1];
+    std::copy(branch->keys, branch->keys + child, keys);
+    keys[child] = childSeparator;
+    std::copy(branch->keys + child, branch->keys + branch->size - 1, keys + child + 1);
+    std::copy(branch->children, branch->children + child + 1, children);
+    children[child + 1] = childRight;
+    std::copy(branch->children + child + 1, branch->children + branch->size, children + child + 2);
+    int size = branch->size + 1;
+
+    if (size <= BRANCH_CAPACITY)
+    {
+        std::copy(keys, keys + size - 1, branch->keys);
+        std::copy(children, children + size, branch->children);
+        branch->size = size;
+        return false;
+    }
+    Branch *sibling = new Branch(); // split in half, the middle key moves up instead of staying in either half
+    this->branchCount++;
+    int leftSize = size / 2;
+    branch->size = leftSize;
+    std::copy(keys, keys + leftSize - 1, branch->keys);
+    std::copy(children, children + leftSize, branch->children);
+    sibling->size = size - leftSize;
+    std::copy(keys + leftSize, keys + size - 1, sibling->keys);
+    std::copy(children + leftSize, children + size, sibling->children);
+    separator = keys[leftSize - 1];
+    right = sibling;
+    return true;
+}
+
+template <typename V>
+bool BPlusTree<V>::insertIntoLeaf(Leaf *leaf, std::uint32_t key, V &value, std::uint32_t &separator, void *&right)
+{
+    int index = int(std::upper_bound(leaf->keys, leaf->keys + leaf->size, key) - leaf->keys);
+    Leaf *sibling = nullptr;
+    if (leaf->size == LEAF_CAPACITY) // split in half, and place the new entry in whichever half it falls in
+    {
+        sibling = new Leaf();
+        this->leafCount++;
+        int half = LEAF_CAPACITY / 2;
+        sibling->size = LEAF_CAPACITY - half;
+        std::move(leaf->keys + half, leaf->keys + LEAF_CAPACITY, sibling->keys);
+        std::move(leaf->values + half, leaf->values + LEAF_CAPACITY, sibling->values);
+        leaf->size = half;
+        sibling->previous = leaf;
+        sibling->next = leaf->next;
+        if (leaf->next != nullptr)
+            leaf->next->previous = sibling;
+        else
+            this->lastLeaf = sibling;
+        leaf->next = sibling;
+    }
+    Leaf *target = leaf;
+    if (sibling != nullptr && index > leaf->size)
+    {
+        target = sibling;
+        index -= leaf->size;
+    }
+    std::move_backward(target->keys + index, target->keys + target->size, target->keys + target->size + 1);
+    std::move_backward(target->values + index, target->values + target->size, target->values + target->size + 1);
+    target->keys[index] = key;
+    target->values[index] = std::move(value);
+    target->size++;
+    if (sibling == nullptr)
+        return false;
+    separator = sibling->keys[0];
+    right = sibling;
+    return true;
+}
+
+template <typename V>
+std::pair<typename BPlusTree<V>::Leaf*, int> BPlusTree<V>::lowerBound(std::uint32_t key)
+{
+    void *node = this->root;
+    for (int level = this->height; level > 0; level--) // before every equal key, later leaves are reached by walking
+    {
+        Branch *branch = static_cast<Branch*>(node);
+        node = branch->children[std::lower_bound(branch->keys, branch->keys + branch->size - 1, key) - branch->keys];
+    }
+    for (Leaf *leaf = static_cast<Leaf*>(node); leaf != nullptr; leaf = leaf->next)
+    {
+        int index = int(std::lower_bound(leaf->keys, leaf->keys + leaf->size, key) - leaf->keys);
+        if (index < leaf->size)
+            return std::make_pair(leaf, index);
+    }
+    return std::make_pair(static_cast<Leaf*>(nullptr), 0);
+}
+
+template <typename V>
+void BPlusTree<V>::destroy(void *node, int level)
+{
+    if (level == 0)
+    {
+        delete static_cast<Leaf*>(node);
+        return;
+    }
+    Branch *branch = static_cast<Branch*>(node);
+    for (int child = 0; child < branch->size; child++)
+        destroy(branch->children[child], level - 1);
+    delete branch;
+}
+
+#endif /* BPlusTree_h */
@@ -0,0 +1,218 @@
+/*
+ Concurrent Hash Table Class
+ This class allows one table to be shared by many threads.
+ Entries are split across a fixed number of shards by the high bits of their key's hash, and each shard is an ordinary HashTable guarded by its own reader / writer lock. A key is hashed once per operation: the same hash picks the shard and is handed to the shard's table.
+ Searches only take a shard's lock in shared mode, so readers never block each other, and writers only block the one shard they touch. With many more shards than threads, operations on different keys rarely meet on the same lock.
+ Since another thread may change the table at any moment, results are returned by value (or through a visitor that runs while the shard is locked) rather than as an index.
+ */
+
+#ifndef ConcurrentHashTable_h
+#define ConcurrentHashTable_h
+
+#include <mutex>
+#include <shared_mutex>
+#include "HashTable.h"
+
+template <typename T, typename Hash = KeyHash>
+class ConcurrentHashTable
+{
+private:
+    struct alignas(64) Shard // own cache line, so locking one shard does not slow down its neighbours
+    {
+        std::shared_mutex lock;
+        HashTable<T, Hash> table;
+        Shard(int capacity, double maxLoad, PROBING_MODE mode) : table(capacity, maxLoad, mode) {}
+    };
+
+    Shard **shards; // one table and lock per shard
+    int shardCount; // power of two
+    int shardBits; // log2 of shardCount
+    Hash hasher; // hash policy applied to keys
+
+    Shard& shardFor(std::uint64_t); // shard that owns a key with the given hash
+
+public:
+    /*
+     Constructor. The initial capacity is spread over the shards, and every shard grows on its own.
+     Pre: number of shards (rounded up to a power of two), initial capacity, maximum load factor, probing mode
+     Post: empty table
+     */
+    ConcurrentHashTable(int = 64, int = 64 * 20, double = 0.5, PROBING_MODE = QUADRATIC_PROBING);
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    bool insert(T, std::string); // inserts under the owning shard's exclusive lock
+    template <typename... Args>
+    bool emplace(std::string, Args&&...); // builds the value in place under the owning shard's exclusive lock
+    bool remove(std::string_view); // removes under the owning shard's exclusive lock
+
+    /*
+     This method searches for a key under the owning shard's shared lock and copies the value out if found.
+     Pre: string, T to receive the value
+     Post: value copied into the given T if found
+     Return: true if found
+     */
+    bool search(std::string_view, T&);
+    bool contains(std::string_view); // true if the key is present
+
+    /*
+     This method searches for a key and calls the visitor on its value while the shard is still locked (shared), avoiding a copy. The visitor must not call back into the table.
+     Pre: string, function taking const T&
+     Post: visitor called if found
+     Return: true if found
+     */
+    template <typename Visitor>
+    bool visit(std::string_view, Visitor);
+
+    void reserve(int); // spreads the given number of entries over the shards and reserves room for them
+    int getCount(); // total entries across all shards (each shard is counted under its own lock)
+    int getShardCount(); // number of shards
+    void stats(); // diplays totals across shards
+
+    ~ConcurrentHashTable();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T, typename Hash>
+ConcurrentHashTable<T, Hash>::ConcurrentHashTable(int requestedShards, int initialCapacity, double maxLoad, PROBING_MODE mode)
+{
+    this->shardCount = 1;
+    this->shardBits = 0;
+    while (this->shardCount < requestedShards)
+    {
+        this->shardCount *= 2;
+        this->shardBits++;
+    }
+    this->shards = new Shard*[this->shardCount];
+    for (int index = 0; index < this->shardCount; index++)
+        this->shards[index] = new Shard(initialCapacity / this->shardCount + 1, maxLoad, mode);
+}
+
+template <typename T, typename Hash>
+bool ConcurrentHashTable<T, Hash>::insert(T value, std::string givenKey)
+{
+    std::uint64_t keyHash = this->hasher(givenKey);
+    Shard &shard = shardFor(keyHash);
+    std::unique_lock<std::shared_mutex> guard(shard.lock);
+    return shard.table.emplaceHashed(std::move(givenKey), keyHash, std::move(value)) != nullptr;
+}
+
+template <typename T, typename Hash>
+template <typename... Args>
+bool ConcurrentHashTable<T, Hash>::emplace(std::string givenKey, Args&&... args)
+{
+    std::uint64_t keyHash = this->hasher(givenKey);
+    Shard &shard = shardFor(keyHash);
+    std::unique_lock<std::shared_mutex> guard(shard.lock);
+    return shard.table.emplaceHashed(std::move(givenKey), keyHash, std::forward<Args>(args)...) != nullptr;
+}
+
+template <typename T, typename Hash>
+bool ConcurrentHashTable<T, Hash>::remove(std::string_view removeValue)
+{
+    std::uint64_t removeHash = this->hasher(removeValue);
+    Shard &shard = shardFor(removeHash);
+    std::unique_lock<std::shared_mutex> guard(shard.lock);
+    return shard.table.removeHashed(removeValue, removeHash);
+}
+
+template <typename T, typename Hash>
+bool ConcurrentHashTable<T, Hash>::search(std::string_view searchValue, T &result)
+{
+    return visit(searchValue, [&result](const T &value) {result = value;});
+}
+
+template <typename T, typename Hash>
+bool ConcurrentHashTable<T, Hash>::contains(std::string_view searchValue)
+{
+    return visit(searchValue, [](const T&) {});
+}
+
+template <typename T, typename Hash>
+template <typename Visitor>
+bool ConcurrentHashTable<T, Hash>::visit(std::string_view searchValue, Visitor visitor)
+{
+    std::uint64_t searchHash = this->hasher(searchValue); // hashed before taking the lock
+    Shard &shard = shardFor(searchHash);
+    std::shared_lock<std::shared_mutex> guard(shard.lock);
+    int index = shard.table.searchHashed(searchValue, searchHash); // search only reads the shard, so readers can share it
+    if (index == -1)
+        return false;
+    visitor(static_cast<const T&>(shard.table[index]));
+    return true;
+}
+
+template <typename T, typename Hash>
+void ConcurrentHashTable<T, Hash>::reserve(int entries)
+{
+    for (int index = 0; index < this->shardCount; index++)
+    {
+        std::unique_lock<std::shared_mutex> guard(this->shards[index]->lock);
+        this->shards[index]->table.reserve(entries / this->shardCount + entries / (this->shardCount * 8) + 1); // hashing leaves shards slightly uneven
+    }
+}
+
+template <typename T, typename Hash>
+int ConcurrentHashTable<T, Hash>::getCount()
+{
+    int total = 0;
+    for (int index = 0; index < this->shardCount; index++)
+    {
+        std::shared_lock<std::shared_mutex> guard(this->shards[index]->lock);
+        total += this->shards[index]->table.getCount();
+    }
+    return total;
+}
+
+template <typename T, typename Hash>
+int ConcurrentHashTable<T, Hash>::getShardCount()
+{return this->shardCount;}
+
+template <typename T, typename Hash>
+void ConcurrentHashTable<T, Hash>::stats()
+{
+    long long slots = 0;
+    int total = 0, fullest = 0;
+    for (int index = 0; index < this->shardCount; index++)
+    {
+        std::shared_lock<std::shared_mutex> guard(this->shards[index]->lock);
+        int shardEntries = this->shards[index]->table.getCount();
+        total += shardEntries;
+        slots += this->shards[index]->table.getSize();
+        if (shardEntries > fullest)
+            fullest = shardEntries;
+    }
+    std::cout << "==================================" << std::endl;
+    std::cout << "Concurrent Hash Table Information:" << std::endl;
+    std::cout << "==================================" << std::endl;
+    std::cout << "Shards: " << this->shardCount << std::endl;
+    std::cout << "Table size: " << slots << std::endl;
+    std::cout << "Items Loaded: " << total << std::endl;
+    std::cout << "Load Factor: " << (slots ? 100.0 * total / slots : 0) << "%" << std::endl;
+    std::cout << "Fullest Shard: " << fullest << " entries" << std::endl;
+}
+
+template <typename T, typename Hash>
+ConcurrentHashTable<T, Hash>::~ConcurrentHashTable()
+{
+    for (int index = 0; index < this->shardCount; index++)
+        delete this->shards[index];
+    delete[] this->shards;
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T, typename Hash>
+typename ConcurrentHashTable<T, Hash>::Shard& ConcurrentHashTable<T, Hash>::shardFor(std::uint64_t keyHash)
+{
+    if (this->shardBits == 0)
+        return *this->shards[0];
+    return *this->shards[keyHash >> (64 - this->shardBits)]; // high bits, independent of the slot chosen inside the shard
+}
+
+#endif /* ConcurrentHashTable_h */
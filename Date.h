@@ -1,17 +1,21 @@
 /*
  Date class
  ==========
- This class serves to mimic a date in the format yyyy/mm/dd.
+ This class serves to mimic a date in the format yyyy-mm-dd.
  It allows updating and intial assigning in the constructor.
  It has methods to ensue that dates given are valid based on leap years and number of days in months.
  Dates can be compared and copied over.
+ The date is stored packed into a single 32 bit value (year << 9 | month << 5 | day), so comparing, copying and hashing are integer operations, and parsing never allocates. Being a single integer, a Date is cheapest to pass by value, and the compiler generated copy and move are plain copies.
  */
 
 #ifndef Date_h
 #define Date_h
 
 #include <stdlib.h>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <iostream>
 #include <fstream>
 
@@ -20,161 +24,180 @@ enum MONTHS{
 };
 
 class Date;
-std::ofstream& operator<<(std::ofstream&, Date&);
-std::ostream& operator<<(std::ostream&, Date&);
-static bool isValidInputForDate(std::string); // determines if a string is in yyyy/mm/dd format
+std::ofstream& operator<<(std::ofstream&, const Date&);
+std::ostream& operator<<(std::ostream&, const Date&);
+static bool isValidInputForDate(std::string_view); // determines if a string is in yyyy-mm-dd format
 
 class Date
 {
 private:
-    MONTHS legalNumberOfDays; // number of max days a month can have
-    std::string year;
-    std::string month;
-    std::string day;
-    int toNumber(std::string); // changes string to number [renaming of std::stoi for readability]
-    bool isLeapYear(); // determines if a year is a leap year (ie. February has 29 days)
-    bool isValidNumber(std::string, int); // determines if string is a number based on given number of expected digits
+    std::uint32_t packedDate = 0; // year << 9 | month << 5 | day, 0 when never assigned
+    static bool toNumber(std::string_view, int&); // changes digits to a number without allocating, false if any char is not a digit
+    static bool isLeapYear(int); // determines if a year is a leap year (ie. February has 29 days)
+    static bool isValidNumber(std::string_view, int); // determines if string is a number based on given number of expected digits
+    void assign(int, int, int); // packs year, month, day, defaulting an illegal month or day to 01
 public:
+    static constexpr int FORMATTED_LENGTH = 10; // characters in yyyy-mm-dd
+
     Date(std::string, std::string, std::string);
     Date();
-    std::string formatDateToPrint(); // returns a date in format yyyy/mm/dd
-    bool operator<(Date);
-    bool operator==(Date);
-    void operator=(Date&);
-    
-    void determineDaysInMonth(); // determines the number of maximum dates in a month
+    std::string formatDateToPrint() const; // returns a date in format yyyy-mm-dd
+    void formatDateTo(char*) const; // writes the 10 characters of yyyy-mm-dd into the given buffer (no terminator, no allocation)
+    bool operator<(Date) const;
+    bool operator==(Date) const;
+
+    int getYear() const;
+    int getMonth() const;
+    int getDay() const;
+    std::uint32_t getPacked() const; // the packed value, ordered the same way as the calendar
+    std::uint32_t hash() const; // well mixed hash of the packed value
+    static std::uint32_t pack(int, int, int); // year, month, day to packed value
+    static Date fromPacked(std::uint32_t); // date holding the given packed value (as made by pack or getPacked)
+
+    MONTHS determineDaysInMonth() const; // determines the number of maximum dates in a month
+    static MONTHS daysInMonth(int, int); // number of days in the given month of the given year
     void updateDate(std::string); // updates the object based on string IF the input is valid, throws exception otherwise
+
+    /*
+     This method reads a date in yyyy-mm-dd format directly from the given characters, without creating any strings. An illegal month or day (ie. 2018-13-40) is set to 01 like updateDate does.
+     Pre: string_view of the date
+     Post: date updated if the format is valid, unchanged otherwise
+     Return: true if the format was valid
+     */
+    bool parse(std::string_view);
 };
 
+static_assert(std::is_trivially_copyable<Date>::value, "Date is copied and moved as a plain integer");
+
 /*
  Public Functions
  */
 
 Date::Date()
 {
-    this->year = this->month = this->day = "";
+    this->packedDate = 0;
 }
 
 Date::Date(std::string y, std::string m, std::string d)
 {
-    if (toNumber(y) >= 0)
-        this->year = y;
-    
-    if (isValidNumber(m, 2))
-    {
-        this->month = m;
-        determineDaysInMonth(); // determine the number of days in the month
-    }
-    else
-    {
-        this->month = "01"; // if not valid set default month value
-        determineDaysInMonth(); // determine the number of days in the month
-    }
-    
-    if (isValidNumber(d, 2) && toNumber(d) <= this->legalNumberOfDays && toNumber(d) >= 1)
-    {
-        this->day = d;
-    }
-    else
-    {
-        this->day = "01"; // if invalid number set default day value;
-    }
-    
+    int year = 0, month = 1, day = 1;
+    if (!toNumber(y, year) || year > 9999)
+        year = 0;
+    if (!isValidNumber(m, 2) || !toNumber(m, month))
+        month = 1; // if not valid set default month value
+    if (!isValidNumber(d, 2) || !toNumber(d, day))
+        day = 1; // if invalid number set default day value
+    assign(year, month, day);
 }
 
-std::string Date::formatDateToPrint()
+std::string Date::formatDateToPrint() const
 {
-    std::string dateToPrint = "";
-    dateToPrint += this->year + "-" + this->month + "-" + this->day;
-    return dateToPrint;
+    char dateToPrint[FORMATTED_LENGTH];
+    formatDateTo(dateToPrint);
+    return std::string(dateToPrint, FORMATTED_LENGTH); // fits in the small string buffer, no heap use
 }
 
+void Date::formatDateTo(char *buffer) const
+{
+    int year = getYear(), month = getMonth(), day = getDay();
+    buffer[0] = char('0' + year / 1000);
+    buffer[1] = char('0' + year / 100 % 10);
+    buffer[2] = char('0' + year / 10 % 10);
+    buffer[3] = char('0' + year % 10);
+    buffer[4] = '-';
+    buffer[5] = char('0' + month / 10);
+    buffer[6] = char('0' + month % 10);
+    buffer[7] = '-';
+    buffer[8] = char('0' + day / 10);
+    buffer[9] = char('0' + day % 10);
+}
 
-bool Date::operator<(Date otherDate) // checks year, then month, then day (larger is actually smaller as in 2015 is younger than 1975)
+bool Date::operator<(Date otherDate) const // larger is actually smaller as in 2015 is younger than 1975
 {
-    if (toNumber(this->year) > toNumber(otherDate.year))
-        return true;
-    else if (toNumber(this->year) == toNumber(otherDate.year))
-    {
-        if (toNumber(this->month) > toNumber(otherDate.month))
-            return true;
-        else if (toNumber(this->month) == toNumber(otherDate.month))
-            return (toNumber(this->day) > toNumber(otherDate.day));
-        else return false;
-    }
-    else return false;
+    return this->packedDate > otherDate.packedDate; // packed value orders by year, then month, then day
 }
 
-bool Date::operator==(Date otherDate)
+bool Date::operator==(Date otherDate) const
 {
-    if (this->formatDateToPrint() == otherDate.formatDateToPrint())
-        return true;
-    else return false;
+    return this->packedDate == otherDate.packedDate;
 }
 
-std::ofstream& operator<<(std::ofstream& outputFile, Date& date)
+std::ofstream& operator<<(std::ofstream& outputFile, const Date& date)
 {
     outputFile << date.formatDateToPrint();
     return outputFile;
 }
 
-std::ostream& operator<<(std::ostream& output, Date& date)
+std::ostream& operator<<(std::ostream& output, const Date& date)
 {
     output << date.formatDateToPrint();
     return output;
 }
 
+int Date::getYear() const {return int(this->packedDate >> 9);}
+int Date::getMonth() const {return int((this->packedDate >> 5) & 0xF);}
+int Date::getDay() const {return int(this->packedDate & 0x1F);}
+std::uint32_t Date::getPacked() const {return this->packedDate;}
+
+std::uint32_t Date::hash() const
+{
+    std::uint32_t value = this->packedDate;
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+std::uint32_t Date::pack(int year, int month, int day)
+{
+    return (std::uint32_t(year) << 9) | (std::uint32_t(month) << 5) | std::uint32_t(day);
+}
 
-void Date::operator=(Date &otherDate)
+Date Date::fromPacked(std::uint32_t packed)
 {
-    this->legalNumberOfDays = otherDate.legalNumberOfDays;
-    this->year = otherDate.year;
-    this->month = otherDate.month;
-    this->day = otherDate.day;
+    Date date;
+    date.packedDate = packed;
+    return date;
 }
 
 void Date::updateDate(std::string newDate)
 {
-    if (isValidInputForDate(newDate))
-    {
-        this->year = newDate.substr(0,4);
-        this->month = newDate.substr(5,2);
-        this->determineDaysInMonth();
-        this->day = newDate.substr(8,2);
-        if (toNumber(this->day) > this->legalNumberOfDays)
-            this->day = "01";
-    }
-    else
+    if (!parse(newDate))
         throw ("[invalid input given for date]");
 }
 
-void Date::determineDaysInMonth()
+bool Date::parse(std::string_view newDate)
+{
+    if (!isValidInputForDate(newDate))
+        return false;
+    int year = 0, month = 0, day = 0;
+    toNumber(newDate.substr(0, 4), year);
+    toNumber(newDate.substr(5, 2), month);
+    toNumber(newDate.substr(8, 2), day);
+    assign(year, month, day);
+    return true;
+}
+
+MONTHS Date::determineDaysInMonth() const
+{
+    return daysInMonth(getYear(), getMonth());
+}
+
+MONTHS Date::daysInMonth(int year, int month)
 {
-    switch(toNumber(this->month))
+    switch(month)
     {
-        case 1:
-        case 3:
-        case 5:
-        case 7:
-        case 8:
-        case 10:
-        case 12:
-            this->legalNumberOfDays = JAN_MAR_MAY_JUL_AUG_OCT_DEC;
-            break;
         case 4:
         case 6:
         case 9:
         case 11:
-            this->legalNumberOfDays = APR_JUN_SEP_NOV;
-            break;
+            return APR_JUN_SEP_NOV;
         case 2:
-            if (isLeapYear())
-                this->legalNumberOfDays = FEBRUARY_LEAP;
-            else this->legalNumberOfDays = FEBRUARY;
-            break;
+            return isLeapYear(year) ? FEBRUARY_LEAP : FEBRUARY;
         default:
-            this->month = "01";
-            determineDaysInMonth();
+            return JAN_MAR_MAY_JUL_AUG_OCT_DEC;
     }
 }
 
@@ -182,34 +205,42 @@ void Date::determineDaysInMonth()
  Private Functions
  */
 
-bool Date::isLeapYear()
+void Date::assign(int year, int month, int day)
 {
-    if(std::stoi(this->year) % 4 == 0)
-    {
-        if (std::stoi(this->year) % 100 == 0)
-        {
-            if (std::stoi(this->year) % 400 == 0)
-                return true;
-            else return false;
-        }
-        else return true;
-    }
-    else return false;
+    if (month < 1 || month > 12)
+        month = 1;
+    if (day < 1 || day > daysInMonth(year, month))
+        day = 1;
+    this->packedDate = pack(year, month, day);
 }
 
-int Date::toNumber(std::string num)
+bool Date::isLeapYear(int year)
 {
-    return std::stoi(num);
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+bool Date::toNumber(std::string_view digits, int &number)
+{
+    if (digits.empty() || digits.length() > 9)
+        return false;
+    number = 0;
+    for (char c : digits)
+    {
+        if (c < '0' || c > '9')
+            return false;
+        number = number * 10 + (c - '0');
+    }
+    return true;
 }
 
 
-bool Date::isValidNumber(std::string number, int expectedLength)
+bool Date::isValidNumber(std::string_view number, int expectedLength)
 {
-    if (number.length() == expectedLength)
+    if (number.length() == std::size_t(expectedLength))
     {
         for (char c : number)
         {
-            if (!isdigit(c)) // ensure every char is in fact a number
+            if (c < '0' || c > '9') // ensure every char is in fact a number
                 return false;
         }
         return true;
@@ -218,17 +249,17 @@ bool Date::isValidNumber(std::string number, int expectedLength)
 }
 
 
-bool isValidInputForDate(std::string date)
+bool isValidInputForDate(std::string_view date)
 {
-    if (date.length() == 10) //  must be in yyyy/mm/dd format
+    if (date.length() == Date::FORMATTED_LENGTH) //  must be in yyyy-mm-dd format
     {
-        if (date[4] == '-' && date[7] == '-') // checks for slashes (/)
+        if (date[4] == '-' && date[7] == '-') // checks for dashes (-)
         {
-            for (int index = 0; index < 10; index++)
+            for (int index = 0; index < Date::FORMATTED_LENGTH; index++)
             {
-                if (index == 4 || index == 7) // skips slashes
+                if (index == 4 || index == 7) // skips dashes
                     continue;
-                else if (!isdigit(date[index])) // ensures every other index is a number
+                else if (date[index] < '0' || date[index] > '9') // ensures every other index is a number
                     return false;
             }
             return true;
@@ -0,0 +1,227 @@
+/*
+ Date Parser Class
+ This class checks and converts many yyyy-mm-dd fields at once, for bulk loading where parsing one date at a time would dominate.
+ Each field is copied into its own 16 byte lane of a small staging block, and a whole lane (or two, with AVX2) is then handled by a few vector instructions: one subtraction turns the characters into digit values, one comparison checks every digit and both dashes, one shuffle drops the dashes, and two multiply-adds combine the digits into year, month and day.
+ The calendar check (month in range, day within the month, February 29 only in leap years) uses a lookup table and arithmetic instead of branches, so a batch full of unpredictable dates runs as fast as a batch of identical ones. The leap year rule is applied to the two halves of the year separately (a year ending in 00 is a leap year if its century is divisible by 4, any other if its last two digits are), which avoids dividing by 100 and 400.
+ Results match Date::parse exactly: a field that is not in yyyy-mm-dd format is rejected, and a well formed field with an illegal month or day (ie. 2018-13-40) has it set to 01.
+ The vector code is compiled for SSE4.1 and AVX2 through function target attributes and picked at run time from what the processor supports, so no special compiler flags are needed. Other compilers and processors use the scalar version, which follows the same steps one field at a time.
+ */
+
+#ifndef DateParser_h
+#define DateParser_h
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "Date.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DATEPARSER_X86 1
+#include <immintrin.h>
+#endif
+
+enum PARSE_KERNEL{
+    SCALAR_KERNEL, SSE4_KERNEL, AVX2_KERNEL, BEST_KERNEL
+};
+
+class DateParser
+{
+private:
+    static const int BLOCK = 256; // fields staged at a time (4 KB of staging, stays in L1)
+    static const int LANE = 16; // bytes of staging per field
+
+    struct Fields // year (as its two halves, ie. 19 and 84), month and day of one field, laid out the way the vector code produces them so they are stored in one go
+    {
+        std::uint16_t century, yearInCentury, month, day;
+    };
+    static void stage(const std::string_view*, int, char*); // copies fields into 16 byte lanes, padded with '0', anything not 10 long becomes a lane that fails the format check
+    static std::uint32_t finish(Fields, bool, bool&); // calendar check and packing of a field (well formed or not), sets the flag if the month or day had to be defaulted, 0 if malformed
+    // kernels: fill in the fields of each staged lane, and whether its characters were in yyyy-mm-dd format
+    static void parseScalar(const char*, int, Fields*, bool*);
+#if defined(DATEPARSER_X86)
+    static void parseSse4(const char*, int, Fields*, bool*);
+    static void parseAvx2(const char*, int, Fields*, bool*);
+#endif
+
+public:
+    static PARSE_KERNEL bestKernel(); // fastest kernel the processor supports
+    static const char* kernelName(PARSE_KERNEL);
+
+    /*
+     This method parses a batch of yyyy-mm-dd fields into packed dates (see Date::getPacked). Fields of the wrong length or with a character out of place are malformed and give 0; well formed fields with an illegal month or day are defaulted the way Date::parse does it. The index of every malformed or defaulted field is added to the invalid list, in order.
+     Pre: array of fields, number of fields, array to receive the packed dates, list to receive invalid indexes, kernel (the best supported one unless one is asked for; a kernel the processor lacks falls back to the next one down)
+     Post: packed[i] holds field i's packed date, or 0 if it was malformed
+     Return: number of malformed fields
+     */
+    static int parseBatch(const std::string_view*, int, std::uint32_t*, std::vector<int>&, PARSE_KERNEL = BEST_KERNEL);
+};
+
+/*
+ Public Functions
+ */
+
+PARSE_KERNEL DateParser::bestKernel()
+{
+#if defined(DATEPARSER_X86)
+    static const PARSE_KERNEL best = __builtin_cpu_supports("avx2") ? AVX2_KERNEL : (__builtin_cpu_supports("sse4.1") ? SSE4_KERNEL : SCALAR_KERNEL);
+    return best;
+#else
+    return SCALAR_KERNEL;
+#endif
+}
+
+const char* DateParser::kernelName(PARSE_KERNEL kernel)
+{
+    switch (kernel)
+    {
+        case SSE4_KERNEL: return "SSE4.1";
+        case AVX2_KERNEL: return "AVX2";
+        case BEST_KERNEL: return kernelName(bestKernel());
+        default: return "scalar";
+    }
+}
+
+int DateParser::parseBatch(const std::string_view *fields, int count, std::uint32_t *packed, std::vector<int> &invalid, PARSE_KERNEL kernel)
+{
+    if (kernel > bestKernel())
+        kernel = bestKernel();
+    alignas(32) char staging[BLOCK * LANE];
+    Fields parsed[BLOCK];
+    bool wellFormed[BLOCK];
+    int malformed = 0;
+    for (int first = 0; first < count; first += BLOCK)
+    {
+        int blockSize = count - first < BLOCK ? count - first : BLOCK;
+        stage(fields + first, blockSize, staging);
+        switch (kernel)
+        {
+#if defined(DATEPARSER_X86)
+            case AVX2_KERNEL: parseAvx2(staging, blockSize, parsed, wellFormed); break;
+            case SSE4_KERNEL: parseSse4(staging, blockSize, parsed, wellFormed); break;
+#endif
+            default: parseScalar(staging, blockSize, parsed, wellFormed); break;
+        }
+        for (int i = 0; i < blockSize; i++)
+        {
+            bool defaulted = false;
+            packed[first + i] = finish(parsed[i], wellFormed[i], defaulted);
+            malformed += !wellFormed[i];
+            if (defaulted || !wellFormed[i]) // rare, so this branch is almost always predicted
+                invalid.push_back(first + i);
+        }
+    }
+    return malformed;
+}
+
+/*
+ Private Functions
+ */
+
+void DateParser::stage(const std::string_view *fields, int count, char *staging)
+{
+    std::memset(staging, '0', std::size_t(count) * LANE);
+    for (int i = 0; i < count; i++)
+    {
+        if (fields[i].size() == std::size_t(Date::FORMATTED_LENGTH))
+            std::memcpy(staging + i * LANE, fields[i].data(), Date::FORMATTED_LENGTH);
+        else staging[i * LANE] = 'x'; // never a digit
+    }
+}
+
+std::uint32_t DateParser::finish(Fields field, bool wellFormed, bool &defaulted)
+{
+    static const std::uint8_t MONTH_DAYS[16] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 0, 0, 0};
+    unsigned century = unsigned(field.century), yearInCentury = unsigned(field.yearInCentury);
+    unsigned year = century * 100 + yearInCentury, month = unsigned(field.month), day = unsigned(field.day);
+    unsigned monthValid = (month - 1) < 12u; // an unsigned compare catches 0 as well
+    month = monthValid * month + (1 - monthValid); // 01 if illegal
+    unsigned leap = ((yearInCentury & 3) == 0) & ((yearInCentury != 0) | ((century & 3) == 0));
+    unsigned monthDays = MONTH_DAYS[month & 15] + (month == 2) * leap;
+    unsigned dayValid = (day - 1) < monthDays;
+    day = dayValid * day + (1 - dayValid);
+    defaulted = wellFormed & !(monthValid & dayValid);
+    return Date::pack(int(year), int(month), int(day)) & (0u - unsigned(wellFormed)); // 0 if malformed
+}
+
+void DateParser::parseScalar(const char *staging, int count, Fields *parsed, bool *wellFormed)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const unsigned char *lane = reinterpret_cast<const unsigned char*>(staging + i * LANE);
+        unsigned digits[Date::FORMATTED_LENGTH], wrong = 0;
+        for (int index = 0; index < Date::FORMATTED_LENGTH; index++)
+        {
+            digits[index] = unsigned(lane[index]) - '0';
+            wrong |= (index == 4 || index == 7) ? lane[index] != '-' : digits[index] > 9; // index known at compile time once unrolled
+        }
+        parsed[i].century = std::uint16_t(digits[0] * 10 + digits[1]);
+        parsed[i].yearInCentury = std::uint16_t(digits[2] * 10 + digits[3]);
+        parsed[i].month = std::uint16_t(digits[5] * 10 + digits[6]);
+        parsed[i].day = std::uint16_t(digits[8] * 10 + digits[9]);
+        wellFormed[i] = wrong == 0;
+    }
+}
+
+#if defined(DATEPARSER_X86)
+
+/*
+ One field per 128 bit register. Lane bytes are yyyy-mm-dd followed by six '0' padding bytes:
+   digits   = bytes - '0'               (a dash becomes 253, any non digit becomes more than 9)
+   format   = digits <= 9 at every digit position, bytes == '-' at positions 4 and 7
+   ordered  = digits shuffled to y y y y m m d d (dashes dropped, rest zeroed)
+   pairs    = ordered multiplied by 10, 1, 10, 1... and added in pairs: [century, year in century, month, day] as 16 bit values, stored straight into Fields
+ */
+__attribute__((target("sse4.1")))
+void DateParser::parseSse4(const char *staging, int count, Fields *parsed, bool *wellFormed)
+{
+    const __m128i zero = _mm_set1_epi8('0'), nine = _mm_set1_epi8(9), dash = _mm_set1_epi8('-');
+    const __m128i dashPositions = _mm_setr_epi8(0, 0, 0, 0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i order = _mm_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i tens = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+    for (int i = 0; i < count; i++)
+    {
+        __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(staging + i * LANE));
+        __m128i digits = _mm_sub_epi8(bytes, zero);
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_max_epu8(digits, nine), nine);
+        __m128i isDash = _mm_cmpeq_epi8(bytes, dash);
+        __m128i format = _mm_blendv_epi8(isDigit, isDash, dashPositions);
+        __m128i pairs = _mm_maddubs_epi16(_mm_shuffle_epi8(digits, order), tens);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(parsed + i), pairs);
+        wellFormed[i] = _mm_movemask_epi8(format) == 0xFFFF;
+    }
+}
+
+/*
+ Same steps as parseSse4, on two fields at once (every instruction used works within each 128 bit half).
+ */
+__attribute__((target("avx2")))
+void DateParser::parseAvx2(const char *staging, int count, Fields *parsed, bool *wellFormed)
+{
+    const __m256i zero = _mm256_set1_epi8('0'), nine = _mm256_set1_epi8(9), dash = _mm256_set1_epi8('-');
+    const __m256i dashPositions = _mm256_setr_epi8(0, 0, 0, 0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                   0, 0, 0, 0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i order = _mm256_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           0, 1, 2, 3, 5, 6, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i tens = _mm256_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+                                          10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+    int i = 0;
+    for (; i + 1 < count; i += 2)
+    {
+        __m256i bytes = _mm256_load_si256(reinterpret_cast<const __m256i*>(staging + i * LANE));
+        __m256i digits = _mm256_sub_epi8(bytes, zero);
+        __m256i isDigit = _mm256_cmpeq_epi8(_mm256_max_epu8(digits, nine), nine);
+        __m256i isDash = _mm256_cmpeq_epi8(bytes, dash);
+        unsigned format = unsigned(_mm256_movemask_epi8(_mm256_blendv_epi8(isDigit, isDash, dashPositions)));
+        __m256i pairs = _mm256_maddubs_epi16(_mm256_shuffle_epi8(digits, order), tens);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(parsed + i), _mm256_castsi256_si128(_mm256_permute4x64_epi64(pairs, 0x08))); // both fields' values side by side
+        wellFormed[i] = (format & 0xFFFFu) == 0xFFFFu;
+        wellFormed[i + 1] = (format >> 16) == 0xFFFFu;
+    }
+    if (i < count) // odd one out
+        parseSse4(staging + i * LANE, 1, parsed + i, wellFormed + i);
+}
+
+#endif /* DATEPARSER_X86 */
+
+#endif /* DateParser_h */
@@ -0,0 +1,185 @@
+/*
+ Fixed Hash Table Class
+ This class is a hash table whose capacity is fixed at compile time, for small lookup tables whose size is known up front.
+ All entries live inline in a std::array of slots, keys included (as InlineKey), so the table never touches the heap and can live on the stack or in static storage.
+ The capacity must be a power of two, so a hash is reduced to a slot with a bit mask rather than a division. Probing is quadratic over triangular numbers (home + 1, + 3, + 6, ...), which visits every slot of a power of two table exactly once.
+ Every operation is constexpr, so a table built from constant data (ie. with the initializer list constructor) can be built and searched entirely at compile time.
+ The name HashTable<T, N> was not available, since HashTable's second template parameter is already its hash policy.
+ */
+
+#ifndef FixedHashTable_h
+#define FixedHashTable_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include "InlineKey.h"
+#include "KeyHash.h"
+
+template <typename T, std::size_t N, std::size_t KeyCapacity = 16, typename Hash = KeyHash>
+class FixedHashTable
+{
+private:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "the capacity of a FixedHashTable must be a power of two");
+
+    enum SLOT_STATE : std::uint8_t { EMPTY, FULL, DELETED };
+
+    struct Slot
+    {
+        InlineKey<KeyCapacity> key;
+        T data{};
+        SLOT_STATE state = EMPTY;
+    };
+
+    static constexpr std::size_t MASK = N - 1;
+
+    std::array<Slot, N> slots{}; // entries stored inline, all EMPTY to begin with
+    int count = 0, deleted = 0; // FULL and DELETED slots
+
+    static constexpr std::size_t probeIndex(std::size_t, std::size_t); // slot visited at the given step of the probe sequence from the given home slot
+
+public:
+    constexpr FixedHashTable() {} // Constructor, empty table
+    constexpr FixedHashTable(std::initializer_list<std::pair<std::string_view, T>>); // Constructor, table holding the given (key, value) pairs
+
+    /*
+     This method takes a template type value and a key, and places the value in the first free (EMPTY or DELETED) slot along the key's probe sequence.
+     Pre: T value, key (no longer than KeyCapacity)
+     Post: Data is inserted into the table if there was room
+     Return: true if inserted, false if the table is full or the key is too long
+     */
+    constexpr bool insert(T, std::string_view);
+
+    /*
+     This method takes a key and walks its probe sequence, stepping over DELETED slots, until it finds the key or reaches an EMPTY slot (or has visited every slot).
+     Pre: key
+     Post: none
+     Return: slot index if found, -1 if not
+     */
+    constexpr int search(std::string_view) const;
+    constexpr bool contains(std::string_view) const; // true if the key is present
+    constexpr bool remove(std::string_view); // marks the key's slot DELETED, true if it was present
+
+    constexpr T& operator[](int); // data held in the slot at the given index (as returned by search)
+    constexpr const T& operator[](int) const;
+    constexpr int getCount() const; // entries in the table
+    static constexpr int getSize(); // slots in the table (N)
+    void stats() const; // diplays table size, entries and load factor
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr FixedHashTable<T, N, KeyCapacity, Hash>::FixedHashTable(std::initializer_list<std::pair<std::string_view, T>> entries)
+{
+    for (const std::pair<std::string_view, T> &entry : entries)
+        insert(entry.second, entry.first);
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr bool FixedHashTable<T, N, KeyCapacity, Hash>::insert(T value, std::string_view givenKey)
+{
+    if (this->count == int(N) || !InlineKey<KeyCapacity>::fits(givenKey))
+        return false;
+    std::size_t home = std::size_t(Hash()(givenKey)) & MASK;
+    for (std::size_t step = 0; step < N; step++)
+    {
+        Slot &slot = this->slots[probeIndex(home, step)];
+        if (slot.state != FULL)
+        {
+            if (slot.state == DELETED)
+                this->deleted--;
+            slot.key = InlineKey<KeyCapacity>(givenKey);
+            slot.data = std::move(value);
+            slot.state = FULL;
+            this->count++;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr int FixedHashTable<T, N, KeyCapacity, Hash>::search(std::string_view searchValue) const
+{
+    std::size_t home = std::size_t(Hash()(searchValue)) & MASK;
+    for (std::size_t step = 0; step < N; step++)
+    {
+        std::size_t index = probeIndex(home, step);
+        const Slot &slot = this->slots[index];
+        if (slot.state == EMPTY) // insert would have used this slot, so the key is not further along
+            return -1;
+        if (slot.state == FULL && slot.key == searchValue)
+            return int(index);
+    }
+    return -1;
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr bool FixedHashTable<T, N, KeyCapacity, Hash>::contains(std::string_view searchValue) const
+{
+    return search(searchValue) != -1;
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr bool FixedHashTable<T, N, KeyCapacity, Hash>::remove(std::string_view removeValue)
+{
+    int index = search(removeValue);
+    if (index == -1)
+        return false;
+    this->slots[std::size_t(index)].state = DELETED;
+    this->slots[std::size_t(index)].data = T();
+    this->count--;
+    this->deleted++;
+    return true;
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr T& FixedHashTable<T, N, KeyCapacity, Hash>::operator[](int index)
+{
+    return this->slots[std::size_t(index)].data;
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr const T& FixedHashTable<T, N, KeyCapacity, Hash>::operator[](int index) const
+{
+    return this->slots[std::size_t(index)].data;
+}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr int FixedHashTable<T, N, KeyCapacity, Hash>::getCount() const
+{return this->count;}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr int FixedHashTable<T, N, KeyCapacity, Hash>::getSize()
+{return int(N);}
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+void FixedHashTable<T, N, KeyCapacity, Hash>::stats() const
+{
+    std::cout << "=============================" << std::endl;
+    std::cout << "Fixed Hash Table Information:" << std::endl;
+    std::cout << "=============================" << std::endl;
+    std::cout << "Table size: " << N << " (fixed)" << std::endl;
+    std::cout << "Items Loaded: " << this->count << std::endl;
+    std::cout << "Deleted Slots: " << this->deleted << std::endl;
+    std::cout << "Load Factor: " << 100.0 * this->count / N << "%" << std::endl;
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T, std::size_t N, std::size_t KeyCapacity, typename Hash>
+constexpr std::size_t FixedHashTable<T, N, KeyCapacity, Hash>::probeIndex(std::size_t home, std::size_t step)
+{
+    return (home + step * (step + 1) / 2) & MASK;
+}
+
+#endif /* FixedHashTable_h */
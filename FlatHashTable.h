@@ -0,0 +1,380 @@
+/*
+ Flat Hash Table Class
+ This class is an alternative storage engine for HashTable with the same insert / search / remove interface.
+ Instead of an array of pointers to separately allocated nodes, entries live inline in one contiguous slot array next to a parallel array of 1 byte control tags.
+ A control tag is either EMPTY, DELETED, or (for an occupied slot) the low 7 bits of the entry's hash. Slots are grouped 16 at a time, and a lookup compares all 16 tags of a group against the key's tag at once (with SSE2 when available), only touching the slot array for tags that match.
+ Capacity is always a power of two (at least one group), and the table grows once it is 7/8 full.
+ Unlike HashTable, entries move when the table grows, so references returned by operator[] are only valid until the next insert.
+ */
+
+#ifndef FlatHashTable_h
+#define FlatHashTable_h
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "KeyHash.h"
+
+template <typename T, typename Hash = KeyHash>
+class FlatHashTable
+{
+private:
+    struct Slot // an entry stored inline in the slot array
+    {
+        std::string key;
+        T data;
+    };
+
+    static const std::int8_t EMPTY = -128; // slot has never held an entry
+    static const std::int8_t DELETED = -2; // slot held an entry that was removed
+    static const int GROUP_WIDTH = 16; // number of control tags compared at once
+
+    std::int8_t *controls = nullptr; // one tag per slot
+    Slot *slots = nullptr; // entries, constructed in place only where the tag is occupied
+    int capacity = 0; // number of slots (power of two)
+    int count = 0, deleted = 0, collisions = 0, attempts = 0, rehashes = 0;
+    // current entries, DELETED tags, inserts that missed their home slot, attempted insertions, and times the table has grown
+    Hash hasher; // hash policy applied to keys
+
+    static std::uint32_t matchTag(const std::int8_t*, std::int8_t); // bit i set if tag i of the group equals the given tag
+    static std::uint32_t matchEmpty(const std::int8_t*); // bit i set if tag i of the group is EMPTY
+    static std::uint32_t matchEmptyOrDeleted(const std::int8_t*); // bit i set if tag i of the group is EMPTY or DELETED
+    static int lowestBit(std::uint32_t); // index of the lowest set bit of a non zero mask
+
+    int findSlot(std::string_view, std::uint64_t); // index of the key, -1 if not present
+    int findInsertSlot(std::uint64_t); // first EMPTY or DELETED slot along the probe sequence of the hash
+    void setControl(int, std::int8_t);
+    void allocate(int); // allocates empty arrays of the given capacity
+
+    /*
+     This method allocates arrays of a new capacity and moves every entry into them, dropping all DELETED tags along the way.
+     Pre: new capacity (power of two)
+     Post: table holds the same entries in the new arrays
+     Return: none
+     */
+    void rehash(int);
+    static int roundUpCapacity(int); // smallest power of two multiple of GROUP_WIDTH that is at least the given number
+
+public:
+    FlatHashTable(int = GROUP_WIDTH); // Constructor, initial capacity
+    FlatHashTable(const FlatHashTable&) = delete;
+    FlatHashTable& operator=(const FlatHashTable&) = delete;
+
+    /*
+     This method takes a template type value and a key, and places the value inline in the first free slot along the key's probe sequence, growing the table first if it would pass 7/8 full.
+     Pre: T value, string
+     Post: Data is inserted into the table
+     Return: true if inserted
+     */
+    bool insert(T, std::string);
+    template <typename... Args>
+    bool emplace(std::string, Args&&...); // like insert, with the value built in its slot from the given constructor arguments
+
+    /*
+     This method takes a string key value and searches the table for it. Each step of the probe sequence compares a whole group of 16 control tags against the key's tag, and stops at the first group that contains an EMPTY tag.
+     Pre: string
+     Post: none
+     Return: slot index if found, -1 if not
+     */
+    int search(std::string_view);
+
+    /*
+     This method takes a string key value and removes the first entry found with that key. The slot is marked EMPTY when its group still has an EMPTY tag (no probe sequence can continue past such a group), and DELETED otherwise so later entries stay reachable.
+     Pre: string
+     Post: if found, data with given key removed
+     Return: true if removed, false if not
+     */
+    bool remove(std::string_view);
+
+    void reserve(int); // grows the table so it can hold the given number of entries without rehashing
+    int getCount(); // returns the amount of entries in the table (ie. count)
+    int getSize(); // returns the number of slots currently allocated
+    T& operator[](int); // data held in the slot at the given index (as returned by search)
+    double calcLoadFactor(); // percentage of slots occupied
+    void displayTable(); // displays table with key - value pairs
+    void stats(); // diplays table size, load factor, collisions, and entries succesfully performed
+
+    ~FlatHashTable();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T, typename Hash>
+FlatHashTable<T, Hash>::FlatHashTable(int initialCapacity)
+{
+    allocate(roundUpCapacity(initialCapacity));
+}
+
+template <typename T, typename Hash>
+bool FlatHashTable<T, Hash>::insert(T value, std::string givenKey)
+{
+    return emplace(std::move(givenKey), std::move(value));
+}
+
+template <typename T, typename Hash>
+template <typename... Args>
+bool FlatHashTable<T, Hash>::emplace(std::string givenKey, Args&&... args)
+{
+    this->attempts++;
+    if ((this->count + this->deleted + 1) * 8 > this->capacity * 7) // keep at least 1/8 of the tags EMPTY
+        rehash(this->count * 2 + 2 > this->capacity ? this->capacity * 2 : this->capacity); // only DELETED tags to clear if mostly empty
+
+    std::uint64_t hash = this->hasher(givenKey);
+    int index = findInsertSlot(hash);
+    if (index != int((hash >> 7) & std::uint64_t(this->capacity - 1)))
+        this->collisions++;
+    if (this->controls[index] == DELETED)
+        this->deleted--;
+    new (&this->slots[index]) Slot{std::move(givenKey), T(std::forward<Args>(args)...)}; // the temporary initializes data directly
+    setControl(index, std::int8_t(hash & 0x7F));
+    this->count++;
+    return true;
+}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::search(std::string_view searchValue)
+{
+    return findSlot(searchValue, this->hasher(searchValue));
+}
+
+template <typename T, typename Hash>
+bool FlatHashTable<T, Hash>::remove(std::string_view removeValue)
+{
+    int index = search(removeValue);
+    if (index == -1)
+        return false;
+    this->slots[index].~Slot();
+    const std::int8_t *group = this->controls + (index & ~(GROUP_WIDTH - 1));
+    if (matchEmpty(group) != 0) // probes never continue past this group
+        setControl(index, EMPTY);
+    else
+    {
+        setControl(index, DELETED);
+        this->deleted++;
+    }
+    this->count--;
+    return true;
+}
+
+template <typename T, typename Hash>
+void FlatHashTable<T, Hash>::reserve(int entries)
+{
+    int needed = roundUpCapacity(entries + entries / 7 + 1);
+    if (needed > this->capacity)
+        rehash(needed);
+}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::getCount()
+{return this->count;}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::getSize()
+{return this->capacity;}
+
+template <typename T, typename Hash>
+T& FlatHashTable<T, Hash>::operator[](int index)
+{
+    return this->slots[index].data;
+}
+
+template <typename T, typename Hash>
+double FlatHashTable<T, Hash>::calcLoadFactor()
+{
+    return (double(this->count) / this->capacity) * 100;
+}
+
+template <typename T, typename Hash>
+void FlatHashTable<T, Hash>::displayTable()
+{
+    std::printf("%-20s %-15s %10s", "Hash Key", "Data", "Index");
+    std::cout  << "\n=================================================================" << std::endl;
+    for (int index = 0; index < this->capacity; index++)
+    {
+        if (this->controls[index] >= 0)
+        {
+            std::cout << std::left << std::setw(22) << this->slots[index].key;
+            std::cout << std::setw(22) << this->slots[index].data;
+            std::cout << std::left << std::setw(13) << index << std::endl;
+        }
+    }
+    std::cout  << "=================================================================" << std::endl;
+}
+
+template <typename T, typename Hash>
+void FlatHashTable<T, Hash>::stats()
+{
+    std::cout << "=======================" << std::endl;
+    std::cout << "Hash Table Information:" << std::endl;
+    std::cout << "=======================" << std::endl;
+    std::cout << "Table size: " << this->capacity << std::endl;
+    std::cout << "Items Loaded: " << this->count << " of " << this->attempts << " attempts" << std::endl;
+    std::cout << "Load Factor: " << this->calcLoadFactor() << "%" << std::endl;
+    std::cout << "Number of Collisions: " << this->collisions << std::endl;
+    std::cout << "Times Rehashed: " << this->rehashes << std::endl;
+}
+
+template <typename T, typename Hash>
+FlatHashTable<T, Hash>::~FlatHashTable()
+{
+    for (int index = 0; index < this->capacity; index++)
+        if (this->controls[index] >= 0)
+            this->slots[index].~Slot();
+    ::operator delete(this->slots);
+    delete[] this->controls;
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T, typename Hash>
+std::uint32_t FlatHashTable<T, Hash>::matchTag(const std::int8_t *group, std::int8_t tag)
+{
+#if defined(__SSE2__)
+    __m128i tags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8(tag))));
+#else
+    std::uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+        if (group[i] == tag)
+            mask |= 1u << i;
+    return mask;
+#endif
+}
+
+template <typename T, typename Hash>
+std::uint32_t FlatHashTable<T, Hash>::matchEmpty(const std::int8_t *group)
+{
+    return matchTag(group, EMPTY);
+}
+
+template <typename T, typename Hash>
+std::uint32_t FlatHashTable<T, Hash>::matchEmptyOrDeleted(const std::int8_t *group)
+{
+#if defined(__SSE2__)
+    // EMPTY and DELETED are the only negative tags, so the sign bits are the answer
+    return std::uint32_t(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+    std::uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+        if (group[i] < 0)
+            mask |= 1u << i;
+    return mask;
+#endif
+}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::lowestBit(std::uint32_t mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while ((mask & 1u) == 0)
+    {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::findSlot(std::string_view key, std::uint64_t hash)
+{
+    const int groupMask = this->capacity / GROUP_WIDTH - 1;
+    const std::int8_t tag = std::int8_t(hash & 0x7F);
+    int group = int((hash >> 7) & std::uint64_t(this->capacity - 1)) / GROUP_WIDTH;
+    for (int step = 1; step <= groupMask + 1; step++) // triangular steps visit every group once
+    {
+        const std::int8_t *groupTags = this->controls + group * GROUP_WIDTH;
+        for (std::uint32_t matches = matchTag(groupTags, tag); matches != 0; matches &= matches - 1)
+        {
+            int index = group * GROUP_WIDTH + lowestBit(matches);
+            if (this->slots[index].key == key)
+                return index;
+        }
+        if (matchEmpty(groupTags) != 0) // key would have been placed here
+            return -1;
+        group = (group + step) & groupMask;
+    }
+    return -1;
+}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::findInsertSlot(std::uint64_t hash)
+{
+    const int groupMask = this->capacity / GROUP_WIDTH - 1;
+    int home = int((hash >> 7) & std::uint64_t(this->capacity - 1));
+    int group = home / GROUP_WIDTH;
+    if (this->controls[home] < 0) // home slot itself is free
+        return home;
+    for (int step = 1; ; step++)
+    {
+        std::uint32_t free = matchEmptyOrDeleted(this->controls + group * GROUP_WIDTH);
+        if (free != 0)
+            return group * GROUP_WIDTH + lowestBit(free);
+        group = (group + step) & groupMask; // at least 1/8 of tags are EMPTY, so this terminates
+    }
+}
+
+template <typename T, typename Hash>
+void FlatHashTable<T, Hash>::setControl(int index, std::int8_t tag)
+{
+    this->controls[index] = tag;
+}
+
+template <typename T, typename Hash>
+void FlatHashTable<T, Hash>::allocate(int newCapacity)
+{
+    this->capacity = newCapacity;
+    this->controls = new std::int8_t[newCapacity];
+    std::memset(this->controls, EMPTY, newCapacity);
+    this->slots = static_cast<Slot*>(::operator new(sizeof(Slot) * newCapacity));
+    this->deleted = 0;
+}
+
+template <typename T, typename Hash>
+void FlatHashTable<T, Hash>::rehash(int newCapacity)
+{
+    std::int8_t *oldControls = this->controls;
+    Slot *oldSlots = this->slots;
+    int oldCapacity = this->capacity;
+    allocate(newCapacity);
+    for (int index = 0; index < oldCapacity; index++)
+    {
+        if (oldControls[index] >= 0)
+        {
+            std::uint64_t hash = this->hasher(oldSlots[index].key);
+            int newIndex = findInsertSlot(hash);
+            new (&this->slots[newIndex]) Slot{std::move(oldSlots[index])};
+            setControl(newIndex, std::int8_t(hash & 0x7F));
+            oldSlots[index].~Slot();
+        }
+    }
+    ::operator delete(oldSlots);
+    delete[] oldControls;
+    this->rehashes++;
+}
+
+template <typename T, typename Hash>
+int FlatHashTable<T, Hash>::roundUpCapacity(int entries)
+{
+    int newCapacity = GROUP_WIDTH;
+    while (newCapacity < entries)
+        newCapacity *= 2;
+    return newCapacity;
+}
+
+#endif /* FlatHashTable_h */
@@ -0,0 +1,140 @@
+/*
+ Hash Multi Table Class
+ This class allows many values to share one key (ie. everyone born on the same date).
+ It is built on a HashTable whose data is a vector of values, so each key occupies a single slot and all of its values sit together in one contiguous group.
+ Fetching every value for a key takes one search of the underlying table, no matter how many values share it.
+ */
+
+#ifndef HashMultiTable_h
+#define HashMultiTable_h
+
+#include <utility>
+#include <vector>
+#include "HashTable.h"
+
+template <typename T, typename Hash = KeyHash>
+class HashMultiTable
+{
+private:
+    HashTable<std::vector<T>, Hash> groups; // one node per key, holding every value for that key
+    int count = 0; // total values across all keys
+
+public:
+    HashMultiTable(int = 20, double = 0.5, PROBING_MODE = QUADRATIC_PROBING); // same as HashTable
+
+    /*
+     This method adds a value under the given key. If the key is already present the value is appended to its group, otherwise a new group is inserted into the table.
+     Pre: T value, string
+     Post: value is stored with the key
+     Return: number of values now stored under the key
+     */
+    int insert(T, std::string);
+    template <typename... Args>
+    int emplace(std::string, Args&&...); // like insert, with the value built at the end of its group from the given constructor arguments
+
+    /*
+     This method finds every value stored under a key with a single search, and returns them as a range of pointers into the key's group. The range is empty (both pointers nullptr) if the key is not present. Pointers are valid until the next insert or remove for the same key.
+     Pre: string
+     Post: none
+     Return: pointers to the first value and one past the last value
+     */
+    std::pair<T*, T*> equalRange(std::string_view);
+
+    /*
+     This method calls the given visitor on every value stored under a key.
+     Pre: string, function taking T&
+     Post: visitor called once per value
+     Return: number of values visited
+     */
+    template <typename Visitor>
+    int forEach(std::string_view, Visitor);
+
+    int countKey(std::string_view); // number of values stored under the key
+    bool remove(std::string_view); // removes every value stored under the key, true if any were removed
+    int getCount(); // total values in the table
+    int getKeyCount(); // distinct keys in the table
+    void stats(); // diplays table information for the underlying table and the number of values
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T, typename Hash>
+HashMultiTable<T, Hash>::HashMultiTable(int initialCapacity, double maxLoad, PROBING_MODE mode)
+    : groups(initialCapacity, maxLoad, mode)
+{
+}
+
+template <typename T, typename Hash>
+int HashMultiTable<T, Hash>::insert(T value, std::string givenKey)
+{
+    return emplace(std::move(givenKey), std::move(value));
+}
+
+template <typename T, typename Hash>
+template <typename... Args>
+int HashMultiTable<T, Hash>::emplace(std::string givenKey, Args&&... args)
+{
+    this->count++;
+    int index = this->groups.search(givenKey);
+    std::vector<T> *group = index == -1 ? this->groups.emplace(std::move(givenKey)) : &this->groups[index]; // first value for the key starts an empty group
+    group->emplace_back(std::forward<Args>(args)...);
+    return int(group->size());
+}
+
+template <typename T, typename Hash>
+std::pair<T*, T*> HashMultiTable<T, Hash>::equalRange(std::string_view searchValue)
+{
+    int index = this->groups.search(searchValue);
+    if (index == -1)
+        return std::pair<T*, T*>(nullptr, nullptr);
+    std::vector<T> &group = this->groups[index];
+    return std::pair<T*, T*>(group.data(), group.data() + group.size());
+}
+
+template <typename T, typename Hash>
+template <typename Visitor>
+int HashMultiTable<T, Hash>::forEach(std::string_view searchValue, Visitor visit)
+{
+    std::pair<T*, T*> range = equalRange(searchValue);
+    for (T *value = range.first; value != range.second; value++)
+        visit(*value);
+    return int(range.second - range.first);
+}
+
+template <typename T, typename Hash>
+int HashMultiTable<T, Hash>::countKey(std::string_view searchValue)
+{
+    std::pair<T*, T*> range = equalRange(searchValue);
+    return int(range.second - range.first);
+}
+
+template <typename T, typename Hash>
+bool HashMultiTable<T, Hash>::remove(std::string_view removeValue)
+{
+    int removedValues = 0;
+    bool removed = this->groups.removeIf(removeValue, [&removedValues](std::vector<T> &group) { // one probe finds the group and removes it
+        removedValues = int(group.size());
+        return true;
+    });
+    this->count -= removedValues;
+    return removed;
+}
+
+template <typename T, typename Hash>
+int HashMultiTable<T, Hash>::getCount()
+{return this->count;}
+
+template <typename T, typename Hash>
+int HashMultiTable<T, Hash>::getKeyCount()
+{return this->groups.getCount();}
+
+template <typename T, typename Hash>
+void HashMultiTable<T, Hash>::stats()
+{
+    this->groups.stats();
+    std::cout << "Values Stored: " << this->count << " under " << this->groups.getCount() << " keys" << std::endl;
+}
+
+#endif /* HashMultiTable_h */
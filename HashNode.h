@@ -1,69 +1,119 @@
 /*
  Hash Node Class
  This class is intended to act as a node for a Hash Table structure.
- As such, the class contains a key of type string, which can be hashed. It also contains a templatized data value.
- The class has a boolean collision indicator to indicate if it caused a collision upon entry into the Hash Table.
+ As such, the class contains a string key, which can be hashed, stored in whatever form the KeyPolicy template parameter gives it (a std::string by default, see KeyPolicy.h). It also contains a templatized data value.
+ The class has a boolean collision indicator to indicate if it caused a collision upon entry into the Hash Table, and records how many probe steps away from its home index it currently sits.
+ The node also keeps the full hash of its key, worked out once by the table when the node is created. Probes compare hashes before keys, so a node holding a different key is almost always rejected without looking at the key itself, and rehashing or displaying the table reads the hash back instead of hashing the key again.
  */
 
 #ifndef HashNode_h
 #define HashNode_h
 
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "KeyPolicy.h"
 #include "Node.h"
 
-template <typename T>
+template <typename T, typename KeyPolicy = StringKeyPolicy>
 class HashNode
 {
 private:
-    std::string key;
+    std::uint64_t hash = 0; // full hash of the key, first so that it shares a cache line with the start of the key
+    typename KeyPolicy::Stored key;
     T data;
     bool collisionFlag = false; // true if caused collision
+    int probeLength = 0; // probe steps between the home index and the current index
     
 public:
-    HashNode(T, std::string); // data and key
-    std::string getKey();
+    HashNode(T, std::string); // data and key, both moved in
+    template <typename... Args>
+    HashNode(std::in_place_t, std::string, Args&&...); // key, then the arguments of T's constructor (data built in place)
+    std::string_view getKey(); // view of the stored key, so reading it never copies it
+    std::uint64_t getHash();
+    void setHash(std::uint64_t); // set by the table once, when the node is created
+    bool matches(std::uint64_t, const typename KeyPolicy::Probe&); // true if the node holds the key with the given hash (the key is only compared if the hashes are equal)
     T& getData();
     void setCollisionFlag(); // sets to true
     bool collision();
+    int getProbeLength();
+    void setProbeLength(int);
     
     void print();
 };
 
 
-template <typename T>
-HashNode<T>::HashNode(T givenData, std::string givenKey)
+template <typename T, typename KeyPolicy>
+HashNode<T, KeyPolicy>::HashNode(T givenData, std::string givenKey) : key(KeyPolicy::store(std::move(givenKey))), data(std::move(givenData))
 {
-    this->data = givenData;
-    this->key = givenKey;
 }
 
-template <typename T>
-std::string HashNode<T>::getKey()
+template <typename T, typename KeyPolicy>
+template <typename... Args>
+HashNode<T, KeyPolicy>::HashNode(std::in_place_t, std::string givenKey, Args&&... args) : key(KeyPolicy::store(std::move(givenKey))), data(std::forward<Args>(args)...)
 {
-    return this->key;
 }
 
-template <typename T>
-T& HashNode<T>::getData()
+template <typename T, typename KeyPolicy>
+std::string_view HashNode<T, KeyPolicy>::getKey()
+{
+    return KeyPolicy::view(this->key);
+}
+
+template <typename T, typename KeyPolicy>
+std::uint64_t HashNode<T, KeyPolicy>::getHash()
+{
+    return this->hash;
+}
+
+template <typename T, typename KeyPolicy>
+void HashNode<T, KeyPolicy>::setHash(std::uint64_t keyHash)
+{
+    this->hash = keyHash;
+}
+
+template <typename T, typename KeyPolicy>
+bool HashNode<T, KeyPolicy>::matches(std::uint64_t keyHash, const typename KeyPolicy::Probe &searchKey)
+{
+    return this->hash == keyHash && KeyPolicy::equal(this->key, searchKey);
+}
+
+template <typename T, typename KeyPolicy>
+T& HashNode<T, KeyPolicy>::getData()
 {
     return this->data;
 }
 
-template <typename T>
-void HashNode<T>::setCollisionFlag()
+template <typename T, typename KeyPolicy>
+void HashNode<T, KeyPolicy>::setCollisionFlag()
 {
     this->collisionFlag = true;
 }
 
-template <typename T>
-bool HashNode<T>::collision()
+template <typename T, typename KeyPolicy>
+bool HashNode<T, KeyPolicy>::collision()
 {
     return this->collisionFlag;
 }
 
-template <typename T>
-void HashNode<T>::print()
+template <typename T, typename KeyPolicy>
+int HashNode<T, KeyPolicy>::getProbeLength()
+{
+    return this->probeLength;
+}
+
+template <typename T, typename KeyPolicy>
+void HashNode<T, KeyPolicy>::setProbeLength(int length)
+{
+    this->probeLength = length;
+}
+
+template <typename T, typename KeyPolicy>
+void HashNode<T, KeyPolicy>::print()
 {
-    std::cout << "Key: " << this->key << " -- Data: " << this->data << std::endl;
+    std::cout << "Key: " << getKey() << " -- Data: " << this->data << std::endl;
 }
 
 
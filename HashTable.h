@@ -1,42 +1,171 @@
 /*
  Hash Table Class
  This class implements a common Hash Table structure using a dynamically created array of a template type.
- Most functionality in the class can be used for any data, but the hashing mechanism MUST be evaluated for its usefulness for each data type a user may use. This is especially important for a UDT.
- 
- Functions that need to be ammended due to unique hasing functions:
- 1. insert
- 2. search
+ Entries are placed by hashing their string key with the Hash template parameter, so the table works for any data type without changes to insert or search.
+ Lookups (search, remove) accept the key as a std::string_view, so a std::string, a string literal or a slice of a larger buffer can be looked up without building a new string; a Date can be given directly as well. Keys are compared by reference, so a search allocates nothing.
+ The default hash (KeyHash) spreads keys over every slot of the table. Any function object taking a std::string_view and returning an unsigned 64 bit value can be used instead; distributionReport can be used to check a new hash before relying on it.
+ Each node keeps the full hash of its key (see HashNode.h). A probe compares that hash before the key, so the entries it passes over on the way are rejected on one integer compare, and the table only ever hashes a key once: rehashing, incremental resizes, displayTable and distributionReport all reuse the stored hash.
+ Removed entries leave a tombstone behind so that probe chains passing through their slot stay intact. Tombstones are cleared whenever the table is rehashed, which also happens (without growing) once they make up too much of the table.
+ How each node stores its key is up to the KeyPolicy template parameter (see KeyPolicy.h). By default every node holds a std::string; with PackedKeyPolicy keys of up to 15 characters are kept inline in 16 bytes and compared in one 128 bit compare, and a key that does not fit is refused by insert and never found by search.
+ Nodes come from the Allocator template parameter (see NodeAllocator.h). The default NodeArena keeps them in large slabs and reuses removed ones, so the table never fragments the heap and is torn down by freeing a few slabs rather than every node.
+ Building with HASHTABLE_METRICS defined adds probe length, rehash and latency counters, read through metricsSnapshot (see HashTableMetrics.h).
+ In ROBIN_HOOD_PROBING mode, an entry being placed takes the slot of any resident that is closer to its own home slot, and the resident continues probing instead. This keeps the longest probe sequence short, and lets a search stop as soon as it meets a resident closer to home than the search itself.
+ In INCREMENTAL_RESIZE mode the table never stops to rebuild itself in one go. Growing allocates the new slot array and keeps the old one alongside it, and every insert, search and remove then moves the entries of a few old slots (MIGRATION_STEP) across, so the cost of a resize is spread over the operations that follow it instead of landing on one unlucky insert. Until the old array is empty, lookups that miss in the new array look in the old one as well, and an entry found there is moved across on the spot, so an index returned by search always refers to the new array. Since searches then change the table, a table searched from several threads at once (ie. inside ConcurrentHashTable) must keep the default STOP_THE_WORLD_RESIZE mode.
+ The table can be walked with standard forward iterators (begin / end, or a range based for loop), which visit every entry in slot order and skip empty slots and tombstones. partition splits the slots into contiguous ranges that can be walked independently, so a sweep over a large table (ie. an export or an aggregate) can be spread over several threads, or handed to std::for_each(std::execution::par, ...). Any insert or remove may rehash the table, which invalidates every iterator.
  */
 
 #ifndef HashTable_h
 #define HashTable_h
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <iomanip>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Date.h"
 #include "HashNode.h"
-#include "StringAssistant.h"
+#include "HashTableMetrics.h"
+#include "KeyHash.h"
+#include "KeyPolicy.h"
+#include "NodeAllocator.h"
 
-template <typename T>
+enum PROBING_MODE{
+    QUADRATIC_PROBING, ROBIN_HOOD_PROBING
+};
+
+enum RESIZE_MODE{
+    STOP_THE_WORLD_RESIZE, INCREMENTAL_RESIZE
+};
+
+template <typename T, typename Hash>
+class HashTableSnapshot; // writes the slot array directly
+
+template <typename T, typename Hash = KeyHash, typename KeyPolicy = StringKeyPolicy, typename Allocator = NodeArena<T, KeyPolicy>>
 class HashTable
 {
 private:
-    HashNode<T> **dataTable; // holds the HashNode pointers
-    const int size = 20; // maximum entries the table can hold
-    int count = 0, collisions = 0, attempts = 0;
-    // current entries, number of collisions that have occured, and attmepted insertions into the table
+    template <typename, typename> friend class HashTableSnapshot;
+    HashNode<T, KeyPolicy> **dataTable; // holds the HashNode pointers
+    int size; // number of slots currently allocated (always prime)
+    int count = 0, collisions = 0, attempts = 0, rehashes = 0, tombstones = 0, longestProbe = 0;
+    // current entries, number of collisions that have occured, attmepted insertions into the table, times the table has been rebuilt, slots holding a tombstone, and the most probe steps any current entry needed
     double loadFactor = 0; // percentage of table filled
+    double maxLoadFactor; // fraction of the table that may be filled (entries and tombstones) before it grows
+    PROBING_MODE probingMode;
+    RESIZE_MODE resizeMode;
+    HashNode<T, KeyPolicy> **previousTable = nullptr; // slots still being drained by an incremental resize, nullptr otherwise
+    int previousSize = 0, migrated = 0; // slots in previousTable, and how many of them have been drained so far
+    static const int MIGRATION_STEP = 8; // previous slots drained by every operation during an incremental resize (at least 2 are needed to finish before the new table fills up)
+    Hash hasher; // hash policy applied to keys
+    Allocator nodes; // creates and destroys every HashNode in the table
+    HASHTABLE_RECORD(MetricsRecorder metrics;) // only present when built with HASHTABLE_METRICS
+    
+    int homeIndex(std::uint64_t); // reduces a key's hash to its home slot in the current table
+    int probeIndex(int, long long); // index visited at the given step of the probe sequence starting at the given home index
+    bool occupied(int); // true if the slot holds an entry (not empty and not a tombstone)
+    static HashNode<T, KeyPolicy>* tombstone(); // marker left in the slot of a removed entry, never dereferenced
+    static void prefetch(const void*); // hints the cpu to start loading the given address into cache
+    struct AnyValue // search predicate accepting the first entry with the key
+    {
+        bool operator()(T&) const {return true;}
+    };
+    template <typename Predicate = AnyValue>
+    int searchFrom(const typename KeyPolicy::Probe&, std::uint64_t, Predicate = Predicate()); // search given the key's probe form and already computed hash, for the first entry with the key whose value satisfies the predicate
+    template <typename Predicate>
+    int locate(std::string_view, std::uint64_t, Predicate); // searches the current table and then the previous one (given the key and its hash), draining a few previous slots first
+    template <typename Predicate>
+    int searchPrevious(const typename KeyPolicy::Probe&, std::uint64_t, Predicate); // searches the table being drained, moving a match into the current table and returning its new index
+    void removeAt(int); // destroys the node at the index and leaves a tombstone in its place
+    int placeNode(HashNode<T, KeyPolicy>*); // places an existing node into the current table without counting it as a new entry, returns its index
+    int robinHoodPlace(HashNode<T, KeyPolicy>*); // places a node, displacing residents that are closer to their home slot, returns its index
+    static HashNode<T, KeyPolicy>** allocateSlots(int); // slot array of the given size, all nullptr
+    static void freeSlots(HashNode<T, KeyPolicy>**);
+    
+    /*
+     This method allocates a table with a new number of slots and moves every existing node into it, re-hashing each one against the new size. Nodes themselves are not copied, only their pointers are moved, and tombstones are dropped.
+     Pre: minimum number of slots
+     Post: table holds the same entries in a (prime sized) array with no tombstones
+     Return: none
+     */
+    void rehash(int);
+    void resize(int); // rebuilds the table with at least the given number of slots, at once or incrementally depending on the resize mode
+    void beginMigration(int); // swaps in a new slot array of at least the given size, keeping the current one to be drained
+    void migrateSlots(int); // moves the entries of the given number of previous slots into the current table, freeing the previous table once it is drained
+    void destroyNodes(); // destroys every entry's node and releases the allocator's memory
+    static int nextPrime(int); // returns the smallest prime greater than or equal to the given number
     
 public:
-    HashTable(); // Constructor
+    class iterator // forward iterator over the entries of the table, in slot order
+    {
+    private:
+        HashNode<T, KeyPolicy> **slots; // table being walked
+        int index, last; // current slot, and the slot the walk stops at
+        void skipFree() {while (this->index < this->last && (this->slots[this->index] == nullptr || this->slots[this->index] == tombstone())) this->index++;} // moves on to the next slot holding an entry
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+        iterator() : slots(nullptr), index(0), last(0) {}
+        iterator(HashNode<T, KeyPolicy> **table, int first, int end) : slots(table), index(first), last(end) {skipFree();} // first entry at or after the first slot
+        T& operator*() const {return this->slots[this->index]->getData();}
+        T* operator->() const {return &this->slots[this->index]->getData();}
+        iterator& operator++() {this->index++; skipFree(); return *this;}
+        iterator operator++(int) {iterator previous = *this; ++*this; return previous;}
+        bool operator==(const iterator &other) const {return this->index == other.index;}
+        bool operator!=(const iterator &other) const {return this->index != other.index;}
+        std::string_view key() const {return this->slots[this->index]->getKey();} // key of the current entry
+        int slot() const {return this->index;} // index of the current entry, as search would return it
+    };
+    
+    class SlotRange // contiguous run of slots, walked with its own begin / end
+    {
+    private:
+        HashNode<T, KeyPolicy> **slots;
+        int first, last; // slots [first, last)
+    public:
+        SlotRange(HashNode<T, KeyPolicy> **table, int from, int to) : slots(table), first(from), last(to) {}
+        iterator begin() const {return iterator(this->slots, this->first, this->last);}
+        iterator end() const {return iterator(this->slots, this->last, this->last);}
+        int getFirstSlot() const {return this->first;}
+        int getLastSlot() const {return this->last;}
+    };
     
     /*
-     This method takes a template type value and a key, and using a hash function it finds a place for the given value as a new node in the table. Hash function in this case is based on type Person, and if data changes, user must ensure that an alternative hash function is used.
+     Constructor. The table starts with (at least) the given number of slots and grows automatically once the load factor passes the given maximum. Since quadratic probing is only guaranteed to find a free slot in a prime sized table that is at most half full, the capacity is rounded up to a prime and the maximum load factor is capped at 0.5.
+     Pre: initial capacity, maximum load factor (0 - 0.5), probing mode, resize mode
+     Post: empty table
+     */
+    HashTable(int = 20, double = 0.5, PROBING_MODE = QUADRATIC_PROBING, RESIZE_MODE = STOP_THE_WORLD_RESIZE);
+    
+    /*
+     This method takes a template type value and a key, and using the table's hash policy on the key it finds a place for the given value as a new node in the table. If the insertion would push the table (counting tombstones) past its maximum load factor, the table is first rehashed: into one roughly twice as large, or at the same size if clearing the tombstones is enough.
      Pre: T value, string
      Post: Data is inserted into the table
-     Return: true if inserted
+     Return: true if inserted, false if the key does not fit the key policy
      */
     bool insert(T, std::string);
     
     /*
-     This method is used to find an alternative index for a value to be inserted if the index found according to the user defined hash function has yielded an occupied index. It continually adds a step value squared and modulo's the entire value by the size of the table. If the value is occupied it does so continually, until a free spot is found.
+     This method inserts a new entry like insert does, but builds the value directly inside its node from the given constructor arguments, so the value is never copied or moved. The key is moved into the node.
+     Pre: string key, arguments for T's constructor
+     Post: Data is inserted into the table
+     Return: pointer to the inserted value, which stays valid until the entry is removed (nodes never move, even when the table is rehashed), or nullptr if the key does not fit the key policy
+     */
+    template <typename... Args>
+    T* emplace(std::string, Args&&...);
+    template <typename... Args>
+    T* emplaceHashed(std::string, std::uint64_t, Args&&...); // same as emplace, given the key's hash (which must be what the table's hash policy gives for it), so a caller that already hashed the key does not hash it again
+    
+    /*
+     This method is used to find an alternative index for a value to be inserted if the index found according to the user defined hash function has yielded an occupied index. It adds an increasing step value squared to the original index and modulo's the entire value by the size of the table. If the value is occupied it does so continually, until a free spot (empty or tombstone) is found.
      Pre: index
      Post: none
      Return: unoccupied index
@@ -44,22 +173,59 @@ public:
     int quadraticProbe(int);
     
     /*
-     This method takes a string key value and searches the table for it's hashed value. If the value is found, the node at this index is removed. Otherwise, the function returns false, indicating the value is not present in the table.
+     This method takes a string key value and searches the table for it's hashed value. If the value is found, the node at this index is removed and a tombstone is left in its slot so that entries further along the probe sequence can still be found. Otherwise, the function returns false, indicating the value is not present in the table.
      Pre: string
      Post: if found, data with given key removed
      Return: true if removed, false if not
      */
-    bool remove(std::string);
+    bool remove(std::string_view);
+    bool remove(Date); // removes the entry keyed by the date's yyyy-mm-dd form
+    bool removeHashed(std::string_view, std::uint64_t); // same as remove, given the key's hash (see emplaceHashed)
     
     /*
-     This method takes a string key value and searches the table for it's hashed value. The method will continually perform quadratic probing on the hashed key for as many times as there are entries in the table. If the key is found at a hashed index, the key is returned, otherwise -1 is returned to symbolize not found.
+     This method removes one specific entry among several that share a key. Entries with the key are visited in probe order and the first one whose value satisfies the predicate is removed, the same way remove does.
+     Pre: string, function taking T& and returning bool
+     Post: if found, that entry removed
+     Return: true if removed, false if no entry with the key matched
+     */
+    template <typename Predicate>
+    bool removeIf(std::string_view, Predicate);
+    
+    /*
+     This method takes a string key value and searches the table for it's hashed value. The method will continually perform quadratic probing on the hashed key, stepping over tombstones, until it reaches an empty slot, which means the key was never inserted past that point. In Robin Hood mode it also stops at a resident that is closer to its home slot than the current probe step. If the key is found at a hashed index, the key is returned, otherwise -1 is returned to symbolize not found.
      Pre: string
      Post: none
      Return: index is found, -1 if not
      */
-    int search(std::string);
+    int search(std::string_view);
+    int search(Date); // searches for the date's yyyy-mm-dd form, formatted on the stack
+    int searchHashed(std::string_view, std::uint64_t); // same as search, given the key's hash (see emplaceHashed)
+    
+    /*
+     This method searches for many keys at once. Lookups in a large table are dominated by cache misses, so instead of finishing one key before starting the next, the keys are handled in windows: every key in a window is hashed and its home slot prefetched, then the nodes in those slots are prefetched, and only then are the probe sequences resolved. The misses of a whole window overlap instead of happening one after another.
+     Pre: array of keys, number of keys, array to receive the results
+     Post: results[i] holds what search(keys[i]) would return
+     Return: none
+     */
+    void searchBatch(const std::string*, int, int*);
+    std::vector<int> searchBatch(const std::vector<std::string>&); // same as above, results returned in a vector
     int getCount(); // returns the amount of entries in the table (ie. count)
-    T& operator[](int); // allows user to treat table as an array by using bracketed index notation
+    int getSize(); // returns the number of slots currently allocated
+    void reserve(int); // grows the table (and its node storage) up front so it can hold the given number of entries without rehashing
+    void clear(); // removes every entry, keeping the current number of slots
+    bool isResizing(); // true while an incremental resize is still draining the previous slot array
+    void finishResize(); // drains whatever is left of an incremental resize at once (ie. ahead of a latency sensitive stretch)
+    T& operator[](int); // allows user to treat table as an array by using bracketed index notation (the slot must hold an entry, ie. an index returned by search)
+    iterator begin(); // first entry in slot order (finishes any incremental resize first)
+    iterator end();
+    
+    /*
+     This method splits the table's slots into the given number of contiguous ranges of (nearly) equal length. Keys are spread evenly over the slots, so each range holds about the same number of entries. The ranges share no slots, so each can be walked on a different thread as long as nothing is inserted, removed or searched for meanwhile. Any incremental resize is finished first.
+     Pre: number of ranges (at least 1)
+     Post: none
+     Return: ranges covering every slot, in slot order
+     */
+    std::vector<SlotRange> partition(int);
     
     /*
      This method calculates the table's load factor. This value is the percentage of spots in the table that are occupied.
@@ -69,11 +235,28 @@ public:
      */
     double calcLoadFactor();
     
-    bool isFull(); // returns true if all spaces in table are occupied
+    bool isFull(); // returns true if all spaces in table are occupied (the table grows before this can happen)
     
     void displayTable(); // displays table with key - value pairs, and collision information for each pair
     void stats(); // diplays table size, load factor, collisions, and entries succesfully performed
-    bool allIndexNull(); // returns true if all indeces of the table are set to nullptr
+    
+    /*
+     This method reports how well the hash policy spreads the current keys. Each entry is counted against its home bucket (the index its key hashes to, before any probing), and the report shows how many buckets received 0, 1, 2... entries, the fullest bucket, and how many entries sit in their home slot.
+     Pre: none
+     Post: report printed to the console
+     Return: none
+     */
+    void distributionReport();
+    bool allIndexNull(); // returns true if no index of the table holds an entry
+    int getLongestProbe(); // most probe steps taken to place any entry since the last rehash
+    
+    /*
+     This method returns the table's counters: probe length histograms for inserts, successful and failed searches, the longest probe ever walked, rehash count and time, and percentiles of sampled operation latencies. The counters only exist when the table is built with HASHTABLE_METRICS, otherwise the snapshot is empty with enabled set to false.
+     Pre: none
+     Post: none
+     Return: snapshot of the counters (toJson gives a machine readable dump)
+     */
+    HashTableMetrics metricsSnapshot();
     
     ~HashTable();
 };
@@ -82,125 +265,352 @@ public:
  Public Functions
  */
 
-template <typename T>
-HashTable<T>::HashTable()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+HashTable<T, Hash, KeyPolicy, Allocator>::HashTable(int initialCapacity, double maxLoad, PROBING_MODE mode, RESIZE_MODE resizing)
 {
-    this->dataTable = new HashNode<T>*[size]{0}; // dynamic table with max size
+    this->probingMode = mode;
+    this->resizeMode = resizing;
+    this->size = nextPrime(initialCapacity < 2 ? 2 : initialCapacity);
+    this->maxLoadFactor = (maxLoad > 0 && maxLoad < 0.5) ? maxLoad : 0.5;
+    this->dataTable = allocateSlots(this->size); // dynamic table, all slots nullptr
 }
 
-template <typename T>
-bool HashTable<T>::allIndexNull()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::allIndexNull()
 {
+    finishResize();
     for (int i = 0; i < size; i++)
-        if (this->dataTable[i] != nullptr)
+        if (occupied(i))
             return false;
     return true;
 }
 
-template <typename T>
-int HashTable<T>::getCount()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::getCount()
 {return this->count;}
 
-template <typename T>
-bool HashTable<T>::insert(T value, std::string givenKey)
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::getSize()
+{return this->size;}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::reserve(int entries)
+{
+    int needed = int(entries / this->maxLoadFactor) + 1;
+    if (needed > this->size)
+        rehash(needed);
+    if (entries > this->count)
+        this->nodes.reserve(entries - this->count);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::clear()
+{
+    destroyNodes();
+    std::fill(this->dataTable, this->dataTable + this->size, nullptr);
+    freeSlots(this->previousTable);
+    this->previousTable = nullptr;
+    this->previousSize = this->migrated = 0;
+    this->count = this->tombstones = this->longestProbe = 0;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::isResizing()
+{return this->previousTable != nullptr;}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::finishResize()
+{
+    if (this->previousTable != nullptr)
+        migrateSlots(this->previousSize - this->migrated);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::getLongestProbe()
+{return this->longestProbe;}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+HashTableMetrics HashTable<T, Hash, KeyPolicy, Allocator>::metricsSnapshot()
+{
+#if defined(HASHTABLE_METRICS)
+    return this->metrics.snapshot();
+#else
+    return HashTableMetrics();
+#endif
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::insert(T value, std::string givenKey)
 {
+    return emplace(std::move(givenKey), std::move(value)) != nullptr;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+template <typename... Args>
+T* HashTable<T, Hash, KeyPolicy, Allocator>::emplace(std::string givenKey, Args&&... args)
+{
+    std::uint64_t keyHash = this->hasher(givenKey); // the only time this key is hashed
+    return emplaceHashed(std::move(givenKey), keyHash, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+template <typename... Args>
+T* HashTable<T, Hash, KeyPolicy, Allocator>::emplaceHashed(std::string givenKey, std::uint64_t keyHash, Args&&... args)
+{
+    HASHTABLE_RECORD(MetricsRecorder::Timer timer(this->metrics, INSERT_OPERATION);)
     this->attempts++; // attempts always increased to show if attempts are failed
-    bool inserted = false;
-    if (this->isFull())
-        return inserted;
+    if (!KeyPolicy::fits(givenKey))
+        return nullptr;
+    if (this->previousTable != nullptr)
+        migrateSlots(MIGRATION_STEP);
+    if (double(this->count + this->tombstones + 1) / this->size > this->maxLoadFactor) // rebuild before the probe chains get long (entries still in the previous table count too)
+        resize(double(this->count + 1) / this->size > this->maxLoadFactor / 2 ? this->size * 2 : this->size);
     
-    HashNode<T>* tempNode = new HashNode<T>(value, givenKey); // create temporary node
-    int hashKey = StringAssistant::hashPersonUsingBirthdate(value); // Person type specific hashing function
-    if (this->dataTable[hashKey] == nullptr) // if initial hash index is not occupied
-    {
-        this->dataTable[hashKey] = tempNode; // insert the node
-        this->count++;
-        inserted = true;
-    }
-    else // a collision has occured
+    HashNode<T, KeyPolicy>* tempNode = this->nodes.create(std::in_place, std::move(givenKey), std::forward<Args>(args)...); // value built inside the node
+    tempNode->setHash(keyHash);
+    if (occupied(homeIndex(tempNode->getHash()))) // a collision has occured
     {
         this->collisions++;
         tempNode->setCollisionFlag(); // nodes hold the knowledge that they have caused a collision
-        hashKey = quadraticProbe(hashKey); // quadratic probe until empty spot found
-        this->dataTable[hashKey] = tempNode; // insert the node
-        this->count++;
-        inserted = true;
     }
-    return inserted;
+    placeNode(tempNode); // probe until a spot is found for the node
+    HASHTABLE_RECORD(this->metrics.recordProbe(INSERT_PROBE, tempNode->getProbeLength());)
+    this->count++;
+    return &tempNode->getData();
 }
 
-template <typename T>
-int HashTable<T>::quadraticProbe(int index)
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::quadraticProbe(int index)
 {
-    for (int step = 1; this->dataTable[index] != nullptr; step++) // while the spots visited are occupied
+    int probe = index;
+    for (long long step = 1; occupied(probe); step++) // while the spots visited are occupied
     {
-        index = (index + (step * step)) % this->size; // (ex. index 6: (6 + (2 * 2)) % 20 = 10)
+        probe = probeIndex(index, step); // (ex. index 6, step 2: (6 + (2 * 2)) % 23 = 10)
     }
-    return index;
+    return probe;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::search(std::string_view searchValue)
+{
+    return searchHashed(searchValue, this->hasher(searchValue));
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::searchHashed(std::string_view searchValue, std::uint64_t searchHash)
+{
+    HASHTABLE_RECORD(MetricsRecorder::Timer timer(this->metrics, SEARCH_OPERATION);)
+    return locate(searchValue, searchHash, AnyValue());
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::search(Date searchDate)
+{
+    char formatted[Date::FORMATTED_LENGTH];
+    searchDate.formatDateTo(formatted);
+    return search(std::string_view(formatted, Date::FORMATTED_LENGTH));
 }
 
-template <typename T>
-int HashTable<T>::search(std::string searchValue)
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::searchBatch(const std::string *keys, int keyCount, int *results)
 {
-    int hashKey = StringAssistant::hashStringBirthdate(searchValue); // type specific hashing function
-    if (this->dataTable[hashKey]->getKey() == searchValue) // if found at first try
-        return hashKey;
-    int counter = 0;
-    for (int step = 1; counter < this->count; counter++, step++)
-        //should not take more attempts than there are entries in the table (ie. counter)
+    if (this->previousTable != nullptr) // keys may be in either table, look them up one at a time until the resize is over
     {
-        hashKey = (hashKey + (step * step)) % this->size; // quadratically probe
-        if (hashKey >= 0 && hashKey < this->size) // if new index is even valid for the table
-            if (this->dataTable[hashKey] != nullptr && this->dataTable[hashKey]->getKey() == searchValue) // check value
-                return hashKey; // if found value, return
+        for (int i = 0; i < keyCount; i++)
+            results[i] = search(keys[i]);
+        return;
     }
-    
-    return -1; // indicates not found
+    const int window = 16; // enough misses in flight to hide memory latency, few enough to stay in cache
+    std::uint64_t hashes[window];
+    int homes[window];
+    for (int first = 0; first < keyCount; first += window)
+    {
+        int last = first + window < keyCount ? first + window : keyCount;
+        for (int i = first; i < last; i++) // hash every key, start loading its home slot
+        {
+            hashes[i - first] = this->hasher(keys[i]);
+            homes[i - first] = homeIndex(hashes[i - first]);
+            prefetch(&this->dataTable[homes[i - first]]);
+        }
+        for (int i = first; i < last; i++) // slots have arrived (or are arriving), start loading the nodes
+            if (occupied(homes[i - first]))
+                prefetch(this->dataTable[homes[i - first]]);
+        for (int i = first; i < last; i++) // nodes are in cache, most keys resolve on the first compare
+            results[i] = KeyPolicy::fits(keys[i]) ? searchFrom(KeyPolicy::probe(keys[i]), hashes[i - first]) : -1;
+    }
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+std::vector<int> HashTable<T, Hash, KeyPolicy, Allocator>::searchBatch(const std::vector<std::string> &keys)
+{
+    std::vector<int> results(keys.size());
+    searchBatch(keys.data(), int(keys.size()), results.data());
+    return results;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+template <typename Predicate>
+int HashTable<T, Hash, KeyPolicy, Allocator>::searchFrom(const typename KeyPolicy::Probe &searchValue, std::uint64_t searchHash, Predicate accept)
+{
+    int homeKey = homeIndex(searchHash);
+    int found = -1; // indicates not found
+    long long step = 0;
+    for (; step < this->size; step++)
+    {
+        int hashKey = probeIndex(homeKey, step); // quadratically probe
+        HashNode<T, KeyPolicy> *node = this->dataTable[hashKey];
+        if (node == nullptr) // an empty slot ends the probe chain, since insert would have used it
+            break;
+        if (node != tombstone()) // tombstones only keep the chain going
+        {
+            if (node->matches(searchHash, searchValue) && accept(node->getData())) // check hash, then key, then value
+            {
+                found = hashKey; // if found value, return
+                break;
+            }
+            if (this->probingMode == ROBIN_HOOD_PROBING && node->getProbeLength() < step)
+                break; // the key would have displaced this resident
+        }
+    }
+    HASHTABLE_RECORD(this->metrics.recordProbe(found == -1 ? MISS_PROBE : HIT_PROBE, int(step));)
+    return found;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+template <typename Predicate>
+int HashTable<T, Hash, KeyPolicy, Allocator>::locate(std::string_view searchValue, std::uint64_t searchHash, Predicate accept)
+{
+    if (this->previousTable != nullptr)
+        migrateSlots(MIGRATION_STEP);
+    if (!KeyPolicy::fits(searchValue)) // could never have been inserted
+        return -1;
+    typename KeyPolicy::Probe searchKey = KeyPolicy::probe(searchValue); // built once, compared against every node on the way
+    int found = searchFrom(searchKey, searchHash, accept);
+    if (found == -1 && this->previousTable != nullptr) // not moved across yet
+        found = searchPrevious(searchKey, searchHash, accept);
+    return found;
 }
 
-template <typename T>
-bool HashTable<T>::remove(std::string removeValue)
+/*
+ Drained slots are left holding a tombstone rather than emptied, so the probe chains of entries still waiting in the previous table stay intact.
+ */
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+template <typename Predicate>
+int HashTable<T, Hash, KeyPolicy, Allocator>::searchPrevious(const typename KeyPolicy::Probe &searchValue, std::uint64_t searchHash, Predicate accept)
 {
-    int elementPosition = this->search(removeValue); // search for value
+    int home = int(searchHash % std::uint64_t(this->previousSize));
+    for (long long step = 0; step < this->previousSize; step++)
+    {
+        int index = int((home + step * step) % this->previousSize);
+        HashNode<T, KeyPolicy> *node = this->previousTable[index];
+        if (node == nullptr)
+            return -1;
+        if (node != tombstone())
+        {
+            if (node->matches(searchHash, searchValue) && accept(node->getData()))
+            {
+                this->previousTable[index] = tombstone();
+                return placeNode(node);
+            }
+            if (this->probingMode == ROBIN_HOOD_PROBING && node->getProbeLength() < step) // probe lengths of entries not yet moved still describe the previous table
+                return -1;
+        }
+    }
+    return -1;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::remove(std::string_view removeValue)
+{
+    return removeHashed(removeValue, this->hasher(removeValue));
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::removeHashed(std::string_view removeValue, std::uint64_t removeHash)
+{
+    HASHTABLE_RECORD(MetricsRecorder::Timer timer(this->metrics, REMOVE_OPERATION);)
+    int elementPosition = locate(removeValue, removeHash, AnyValue()); // search for value
     if (elementPosition == -1) // -1 indicates not found
         return false;
-    else
-    { // delete the node at the index
-        delete this->dataTable[elementPosition];
-        this->dataTable[elementPosition] = nullptr;
-        this->count--;
-        return true;
-    }
+    removeAt(elementPosition);
+    return true;
 }
 
-template <typename T>
-bool HashTable<T>::isFull()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+template <typename Predicate>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::removeIf(std::string_view removeValue, Predicate accept)
+{
+    HASHTABLE_RECORD(MetricsRecorder::Timer timer(this->metrics, REMOVE_OPERATION);)
+    int elementPosition = locate(removeValue, this->hasher(removeValue), accept);
+    if (elementPosition == -1)
+        return false;
+    removeAt(elementPosition);
+    return true;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::remove(Date removeDate)
+{
+    char formatted[Date::FORMATTED_LENGTH];
+    removeDate.formatDateTo(formatted);
+    return remove(std::string_view(formatted, Date::FORMATTED_LENGTH));
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::isFull()
 {
     return (count >= size);
 }
 
-template <typename T>
-double HashTable<T>::calcLoadFactor()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+double HashTable<T, Hash, KeyPolicy, Allocator>::calcLoadFactor()
 {
     this->loadFactor = (double(this->count)/this->size) * 100;
     return this->loadFactor;
 }
 
-template <typename T>
-T& HashTable<T>::operator[](int index)
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+T& HashTable<T, Hash, KeyPolicy, Allocator>::operator[](int index)
 {
     return this->dataTable[index]->getData();
 }
 
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+typename HashTable<T, Hash, KeyPolicy, Allocator>::iterator HashTable<T, Hash, KeyPolicy, Allocator>::begin()
+{
+    finishResize();
+    return iterator(this->dataTable, 0, this->size);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+typename HashTable<T, Hash, KeyPolicy, Allocator>::iterator HashTable<T, Hash, KeyPolicy, Allocator>::end()
+{
+    return iterator(this->dataTable, this->size, this->size);
+}
 
-template <typename T>
-void HashTable<T>::displayTable()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+std::vector<typename HashTable<T, Hash, KeyPolicy, Allocator>::SlotRange> HashTable<T, Hash, KeyPolicy, Allocator>::partition(int parts)
 {
+    finishResize();
+    if (parts < 1)
+        parts = 1;
+    std::vector<SlotRange> ranges;
+    ranges.reserve(parts);
+    for (int part = 0; part < parts; part++)
+        ranges.emplace_back(this->dataTable, int((long long)this->size * part / parts), int((long long)this->size * (part + 1) / parts));
+    return ranges;
+}
+
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::displayTable()
+{
+    finishResize();
     std::printf("%-20s %-15s %10s %10s %5s", "Hash Key", "Data", "Index", "C?", "IPC");
     std::cout  << "\n=================================================================" << std::endl;
     for (int index = 0; index < this->size; index++)
     {
-        if (this->dataTable[index] != nullptr)
+        if (occupied(index))
         {
             std::cout << std::left << std::setw(22) << this->dataTable[index]->getKey();
             std::cout << std::setw(22) << this->dataTable[index]->getData();
@@ -208,7 +618,7 @@ void HashTable<T>::displayTable()
             if (this->dataTable[index]->collision())
             {
                 std::cout << std::left << std::setw(5) << "*";
-                std::cout << std::left << std::setw(10) << StringAssistant::hashPersonUsingBirthdate(this->dataTable[index]->getData());
+                std::cout << std::left << std::setw(10) << homeIndex(this->dataTable[index]->getHash());
             }
             std::cout << std::endl;
         }
@@ -218,8 +628,8 @@ void HashTable<T>::displayTable()
     std::cout  << "=================================================================" << std::endl;
 }
 
-template <typename T>
-void HashTable<T>::stats()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::stats()
 {
     std::cout << "=======================" << std::endl;
     std::cout << "Hash Table Information:" << std::endl;
@@ -228,20 +638,273 @@ void HashTable<T>::stats()
     std::cout << "Items Loaded: " << this->count << " of " << this->attempts << " attempts" << std::endl;
     std::cout << "Load Factor: " << this->calcLoadFactor() << "%" << std::endl;
     std::cout << "Number of Collisions: " << this->collisions << std:: endl;
+    std::cout << "Times Rehashed: " << this->rehashes << std::endl;
+    std::cout << "Longest Probe: " << this->longestProbe << std::endl;
+    if (this->previousTable != nullptr)
+        std::cout << "Resize In Progress: " << this->migrated << " of " << this->previousSize << " previous slots drained" << std::endl;
 }
 
-template <typename T>
-HashTable<T>::~HashTable<T>()
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::distributionReport()
 {
-    if (this->count == 0)
-        delete[] this->dataTable;
-    else
+    finishResize();
+    std::vector<int> bucketLoad(this->size, 0); // entries whose key hashes to each bucket
+    int atHome = 0, fullest = 0;
+    for (int index = 0; index < this->size; index++)
+    {
+        if (occupied(index))
+        {
+            int home = homeIndex(this->dataTable[index]->getHash());
+            bucketLoad[home]++;
+            if (home == index)
+                atHome++;
+        }
+    }
+    const int lastRow = 8; // buckets with 8 or more entries share the last row
+    std::vector<int> histogram(lastRow + 1, 0);
+    for (int load : bucketLoad)
+    {
+        histogram[load < lastRow ? load : lastRow]++;
+        if (load > fullest)
+            fullest = load;
+    }
+    std::cout << "=======================" << std::endl;
+    std::cout << "Bucket Distribution:" << std::endl;
+    std::cout << "=======================" << std::endl;
+    std::printf("%-15s %10s %10s\n", "Entries/Bucket", "Buckets", "Percent");
+    for (int load = 0; load <= lastRow; load++)
+        std::printf("%-15s %10d %9.2f%%\n", (std::to_string(load) + (load == lastRow ? "+" : "")).c_str(), histogram[load], 100.0 * histogram[load] / this->size);
+    std::cout << "Buckets used: " << this->size - histogram[0] << " of " << this->size << std::endl;
+    std::cout << "Fullest bucket: " << fullest << " entries" << std::endl;
+    if (this->count > 0)
+        std::cout << "Entries in home slot: " << atHome << " of " << this->count << " (" << 100.0 * atHome / this->count << "%)" << std::endl;
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::homeIndex(std::uint64_t keyHash)
+{
+    return int(keyHash % std::uint64_t(this->size));
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::probeIndex(int home, long long step)
+{
+    return int((home + (step * step)) % this->size);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+bool HashTable<T, Hash, KeyPolicy, Allocator>::occupied(int index)
+{
+    return this->dataTable[index] != nullptr && this->dataTable[index] != tombstone();
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+HashNode<T, KeyPolicy>* HashTable<T, Hash, KeyPolicy, Allocator>::tombstone()
+{
+    alignas(HashNode<T, KeyPolicy>) static char marker[sizeof(HashNode<T, KeyPolicy>)]; // unique address, no HashNode is ever built here
+    return reinterpret_cast<HashNode<T, KeyPolicy>*>(marker);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::prefetch(const void *address)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::placeNode(HashNode<T, KeyPolicy> *node)
+{
+    if (this->probingMode == ROBIN_HOOD_PROBING)
+        return robinHoodPlace(node);
+    int home = homeIndex(node->getHash());
+    int index = home;
+    long long step = 0;
+    while (occupied(index))
+        index = probeIndex(home, ++step);
+    if (this->dataTable[index] == tombstone()) // tombstones can be reused, search skips them either way
+        this->tombstones--;
+    node->setProbeLength(int(step));
+    this->dataTable[index] = node;
+    if (step > this->longestProbe)
+        this->longestProbe = int(step);
+    return index;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::removeAt(int index)
+{
+    this->nodes.destroy(this->dataTable[index]); // the allocator keeps the memory for the next insert
+    this->dataTable[index] = tombstone();
+    this->tombstones++;
+    this->count--;
+    if (this->tombstones > this->size / 4 && this->tombstones > this->count) // periodic cleanup under churn
+        resize(this->size);
+}
+
+/*
+ A prime sized table that is at most half full (tombstones included) always has an empty slot within the first half of any quadratic probe sequence, so the evicted resident always finds a home further along its own sequence.
+ Tombstones are stepped over rather than reused in this mode: a slot's resident only ever gets further from home, which is what allows search to stop early.
+ */
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::robinHoodPlace(HashNode<T, KeyPolicy> *node)
+{
+    int home = homeIndex(node->getHash());
+    int placed = -1; // where the given node itself ended up
+    for (long long step = 0; step < this->size; step++)
+    {
+        int index = probeIndex(home, step);
+        HashNode<T, KeyPolicy> *resident = this->dataTable[index];
+        if (resident == nullptr || (resident != tombstone() && resident->getProbeLength() < step))
+        {
+            node->setProbeLength(int(step));
+            this->dataTable[index] = node;
+            if (placed == -1)
+                placed = index;
+            if (step > this->longestProbe)
+                this->longestProbe = int(step);
+            if (resident == nullptr)
+                return placed;
+            node = resident; // the resident was closer to home, so it continues probing from where it was
+            home = homeIndex(node->getHash());
+            step = node->getProbeLength();
+        }
+    }
+    return placed;
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::rehash(int minimumSize)
+{
+    finishResize();
+    HASHTABLE_RECORD(auto rehashStart = std::chrono::steady_clock::now();)
+    HashNode<T, KeyPolicy> **oldTable = this->dataTable;
+    int oldSize = this->size;
+    this->size = nextPrime(minimumSize);
+    this->dataTable = allocateSlots(this->size);
+    this->tombstones = 0;
+    this->longestProbe = 0;
+    for (int index = 0; index < oldSize; index++)
+        if (oldTable[index] != nullptr && oldTable[index] != tombstone())
+            placeNode(oldTable[index]); // node keeps its hash and its collision flag from its original insertion
+    freeSlots(oldTable);
+    this->rehashes++;
+    HASHTABLE_RECORD(this->metrics.recordRehash(std::chrono::steady_clock::now() - rehashStart);)
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::resize(int minimumSize)
+{
+    if (this->resizeMode == INCREMENTAL_RESIZE)
+        beginMigration(minimumSize);
+    else rehash(minimumSize);
+}
+
+/*
+ Only the new slot array is allocated here. It comes from calloc, which gets large blocks straight from the operating system already zeroed, so even a huge array costs no more than a system call up front and its pages are filled in as entries land on them.
+ A resize requested while the previous one is still draining finishes that one first. Every operation drains MIGRATION_STEP slots, so the previous table is empty long before the new one can fill up; finishing early is a safety net rather than a pause that happens in practice.
+ */
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::beginMigration(int minimumSize)
+{
+    finishResize();
+    HASHTABLE_RECORD(auto rehashStart = std::chrono::steady_clock::now();)
+    this->previousTable = this->dataTable;
+    this->previousSize = this->size;
+    this->migrated = 0;
+    this->size = nextPrime(minimumSize);
+    this->dataTable = allocateSlots(this->size);
+    this->tombstones = 0;
+    this->longestProbe = 0;
+    this->rehashes++;
+    HASHTABLE_RECORD(this->metrics.recordRehash(std::chrono::steady_clock::now() - rehashStart);)
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::migrateSlots(int slots)
+{
+    int last = this->previousSize - this->migrated > slots ? this->migrated + slots : this->previousSize;
+    for (; this->migrated < last; this->migrated++)
+    {
+        HashNode<T, KeyPolicy> *node = this->previousTable[this->migrated];
+        if (node != nullptr && node != tombstone())
+        {
+            this->previousTable[this->migrated] = tombstone(); // keeps the chains through this slot intact for searchPrevious
+            placeNode(node);
+        }
+    }
+    if (this->migrated == this->previousSize)
+    {
+        freeSlots(this->previousTable);
+        this->previousTable = nullptr;
+        this->previousSize = this->migrated = 0;
+    }
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+HashNode<T, KeyPolicy>** HashTable<T, Hash, KeyPolicy, Allocator>::allocateSlots(int slots)
+{
+    void *memory = std::calloc(std::size_t(slots), sizeof(HashNode<T, KeyPolicy>*));
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return static_cast<HashNode<T, KeyPolicy>**>(memory);
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::freeSlots(HashNode<T, KeyPolicy> **slots)
+{
+    std::free(slots);
+}
+
+/*
+ Nodes only have to be destroyed one at a time if destroying them does something (ie. frees a long key or value) or if the allocator cannot free them all at once.
+ */
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+void HashTable<T, Hash, KeyPolicy, Allocator>::destroyNodes()
+{
+    if (!Allocator::RELEASES_IN_BULK || !std::is_trivially_destructible<HashNode<T, KeyPolicy>>::value)
     {
         for (int index = 0; index < this->size; index++)
-            if (this->dataTable[index] != nullptr)
-                delete this->dataTable[index];
-        delete[] this->dataTable;
+            if (occupied(index))
+                this->nodes.destroy(this->dataTable[index]);
+        for (int index = this->migrated; index < this->previousSize; index++) // entries not yet moved by an incremental resize
+            if (this->previousTable[index] != nullptr && this->previousTable[index] != tombstone())
+                this->nodes.destroy(this->previousTable[index]);
+    }
+    this->nodes.release();
+}
+
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+int HashTable<T, Hash, KeyPolicy, Allocator>::nextPrime(int number)
+{
+    if (number <= 2)
+        return 2;
+    if (number % 2 == 0)
+        number++;
+    for (;; number += 2)
+    {
+        bool prime = true;
+        for (int divisor = 3; (long long)divisor * divisor <= number && prime; divisor += 2)
+            if (number % divisor == 0)
+                prime = false;
+        if (prime)
+            return number;
     }
 }
 
+template <typename T, typename Hash, typename KeyPolicy, typename Allocator>
+HashTable<T, Hash, KeyPolicy, Allocator>::~HashTable()
+{
+    destroyNodes();
+    freeSlots(this->dataTable);
+    freeSlots(this->previousTable);
+}
+
 #endif /* HashTable_h */
@@ -1,29 +1,124 @@
 /*
  Hash Table Manager Class
  This class intends to allow a user to a user to provide an input file, which will be parsed to create Person type objects, which will be entered into a Hash Table instance present in the class. The class allows users to search for entreis based on a key value, view the table, and view table stats.
+ The input file is memory mapped and split into records in place, and birthdates are checked and converted thousands at a time by DateParser, so loading a large file is bound by how fast it can be read rather than by parsing.
+ Birthdate keys are always 10 characters, so the table keeps them inline in each node as a PackedKey (see KeyPolicy.h) rather than in a std::string.
+ Besides the birthdate table, every entry is indexed by name in a radix trie, which answers exact name and name prefix searches. Entries are also ordered by birthdate in a B+ tree keyed on the packed date, which answers range, count and earliest / latest queries without scanning the table.
+ Both indexes only hold pointers to the entries stored in the table (which never move), and insert / remove keep all three in step.
+ In pipeline mode (runPipeline) records keep arriving from a feed while queries are answered, through an IngestPipeline rather than the table and indexes above.
  */
 
 #ifndef HashTableManager_h
 #define HashTableManager_h
 
 #include "HashTable.h"
+#include "BPlusTree.h"
+#include "DateParser.h"
+#include "HashTableSnapshot.h"
+#include "IngestPipeline.h"
+#include "MappedFile.h"
+#include "RadixTrie.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <string_view>
+#include <vector>
 
 template <typename T>
 class HashTableManager
 {
 private:
     std::string inputFileAddress;
-    HashTable<T> personTable; // data table being read into
+    HashTable<T, KeyHash, PackedKeyPolicy> personTable; // data table being read into, keyed by yyyy-mm-dd birthdates (which always fit a PackedKey)
+    RadixTrie<T*> nameIndex; // every entry of personTable by name
+    BPlusTree<T*> dateIndex; // every entry of personTable by packed birthdate
+    std::vector<std::size_t> invalidDateLines; // line numbers (from 1) of birthdates that were malformed or had an illegal month or day, over every load
     bool readFromInputFile(); // reads from the user given inout file
+    static std::string_view nextLine(std::string_view, std::size_t&); // line starting at the given offset (without its line ending), offset moved past it
     bool getInputFile(); // ensures input file is open-able
     void clearInput(); // removes illegal input for cin.fail()
     bool searchAgain(); // prompts user if to continue searching for entries
     void innerMenu(int); // proccesses menu option chosen
     void pressEnterToContinue();
 public:
+    /*
+     This method loads every record (a name line followed by a yyyy-mm-dd line) of the file at the given address into the table. The file is memory mapped, the number of records is counted from its line endings so the table can be sized once up front, and names and dates are read straight out of the mapping. Records are split out a few thousand at a time and their dates parsed as one batch. Records whose date line is not in yyyy-mm-dd format are skipped, as are blank lines at the end of the file; the line numbers of those dates, and of dates whose illegal month or day was set to 01, are kept (see getInvalidDateLines).
+     Pre: file address
+     Post: records inserted into the table
+     Return: true if the file could be read
+     */
+    bool bulkLoad(std::string);
+    
+    /*
+     This method runs the manager without any prompts, for use from scripts. The input file is loaded (or, if it is a snapshot written by createSnapshot, mapped), then every line of the query stream (a file, or standard input for "-") is looked up as a birthdate. Lines are checked before any lookup and searched as a Date, so an out of range month or day defaults to 01 just as it does in the menu and on load. Each query is answered on standard output as "date<TAB>name", "date<TAB>NOT FOUND" or "date<TAB>INVALID", in the order given. Lookups are made in batches and output is buffered, and totals for loading and querying (counts, time, throughput and average latency) are printed to standard error at the end.
+     Pre: input file address, query file address or "-"
+     Post: answers written to standard output, totals to standard error
+     Return: process exit code (0 on success)
+     */
+    int runBatch(std::string, std::string);
+    
+    /*
+     This method answers birthdate queries while records are still arriving. The feed (a pipe, a FIFO, standard input, or a file that is still being appended to) is ingested in the background by an IngestPipeline, and every line of the query stream is answered against whatever has been inserted by the time it is read, in the same format as runBatch. Answers to queries from standard input are written out immediately. Once the queries run out, the method waits for the feed to end and prints ingest throughput, visibility latency (from a record being read to it being searchable) and query totals to standard error.
+     Pre: feed address or "-", query file address or "-" (not both standard input)
+     Post: answers written to standard output, totals to standard error
+     Return: process exit code (0 on success)
+     */
+    int runPipeline(std::string, std::string);
+    
+    /*
+     This method loads an input file and saves the resulting table as a binary snapshot. runBatch accepts the snapshot in place of the input file and only maps it, instead of parsing and hashing every record again.
+     Pre: input file address, snapshot file address
+     Post: snapshot written
+     Return: process exit code (0 on success)
+     */
+    int createSnapshot(std::string, std::string);
     void menu(); // menu with functionality
     void enterBirthday(); // prompts user for birthdates to search for
+    void enterName(); // prompts user for name prefixes to search for
+    void enterDateRange(); // prompts user for a range of birthdates to list
+    
+    /*
+     This method adds a person to the birthdate table and the name index.
+     Pre: T value
+     Post: value stored and indexed
+     Return: true if inserted, false if its birthday does not fit the table's key policy
+     */
+    bool insert(T);
+    
+    /*
+     This method removes one specific person (same name and birthdate) from the birthdate table and the name index. Other people sharing the birthdate or the name are left alone.
+     Pre: T value to remove
+     Post: value removed from both if found
+     Return: true if removed
+     */
+    bool remove(const T&);
+    
+    /*
+     These methods call the visitor on every entry with exactly the given name, or with a name starting with the given prefix (in alphabetical order of name).
+     Pre: name or prefix, function taking T&
+     Post: visitor called once per entry
+     Return: number of entries visited
+     */
+    template <typename Visitor>
+    int forEachWithName(std::string_view, Visitor);
+    template <typename Visitor>
+    int forEachWithNamePrefix(std::string_view, Visitor);
+    
+    /*
+     This method calls the visitor on every entry born between the two given dates (both included), from the earliest birthdate to the latest.
+     Pre: first date, last date, function taking T&
+     Post: visitor called once per entry
+     Return: number of entries visited
+     */
+    template <typename Visitor>
+    int forEachBornBetween(Date, Date, Visitor);
+    int countBornBetween(Date, Date); // number of entries born between the two dates (both included)
+    T* earliestBorn(); // entry with the earliest birthdate, nullptr if there are none
+    T* latestBorn(); // entry with the latest birthdate, nullptr if there are none
+    const std::vector<std::size_t>& getInvalidDateLines(); // line numbers of malformed (skipped) or defaulted birthdates found by every load so far
 };
 
 template <typename T>
@@ -35,14 +130,16 @@ void HashTableManager<T>::menu()
             std::cout << "=======================" << std::endl;
             std::cout << "Hash Table Manager Menu" << std::endl;
             std::cout << "=======================\n" << std::endl;
-            while (choice != 4)
+            while (choice != 6)
             {
                 std::cout << "[1] - Search for entries" << std::endl;
-                std::cout << "[2] - See Table Statistics" << std::endl;
-                std::cout << "[3] - Display Table With Collision Info" << std::endl;
-                std::cout << "[4] - Exit\n--> ";
+                std::cout << "[2] - Search for entries by name" << std::endl;
+                std::cout << "[3] - List entries born between two dates" << std::endl;
+                std::cout << "[4] - See Table Statistics" << std::endl;
+                std::cout << "[5] - Display Table With Collision Info" << std::endl;
+                std::cout << "[6] - Exit\n--> ";
                 std::cin >> choice;
-                while (std::cin.fail() || choice < 1 || choice > 4)
+                while (std::cin.fail() || choice < 1 || choice > 6)
                 {
                     clearInput();
                     std::cout << "*** invalid input***\n--> ";
@@ -74,14 +171,13 @@ void HashTableManager<T>::enterBirthday()
         std::cin.ignore();
         std::cout << "Enter date in [yyyy-mm-dd] format: ";
         getline(std::cin, input);
-        if (isValidInputForDate(input))
+        Date birthDate;
+        if (birthDate.parse(input)) // searched as a Date, so an out of range month or day defaults the same way it did on load
         {
-            Date temp;
-            temp.updateDate(input);
-            int search = this->personTable.search(input);
+            int search = this->personTable.search(birthDate);
             if (search != -1)
-                std::cout << "Found at resultant index [" << search << "] - {" << input << ", " << this->personTable[search] << "}";
-            else std::cout << "No entry with birthdate [" << input << "] found in this data table";
+                std::cout << "Found at resultant index [" << search << "] - {" << birthDate << ", " << this->personTable[search] << "}";
+            else std::cout << "No entry with birthdate [" << birthDate << "] found in this data table";
             std::cout << std::endl;
         }
         else std::cout << "*** invalid input - please use [yyyy/mm/dd] format ***" << std::endl;
@@ -90,27 +186,437 @@ void HashTableManager<T>::enterBirthday()
 }
 
 template <typename T>
-bool HashTableManager<T>::readFromInputFile()
+void HashTableManager<T>::enterName()
 {
-    std::ifstream inputFile;
-    inputFile.open(this->inputFileAddress);
-    if (inputFile)
+    const int shown = 20; // matches listed before the rest are only counted
+    std::string input;
+    do
     {
-        while (!inputFile.eof())
+        std::cin.ignore();
+        std::cout << "Enter a name, or the beginning of one: ";
+        getline(std::cin, input);
+        int listed = 0;
+        int matches = this->nameIndex.forEachPrefix(input, [&listed](T *person) {
+            if (listed++ < shown)
+                std::cout << "{" << person->getName() << ", " << person->getBirthday() << "}" << std::endl;
+        });
+        if (matches == 0)
+            std::cout << "No entry with a name starting with [" << input << "] found in this data table" << std::endl;
+        else if (matches > shown)
+            std::cout << "... and " << matches - shown << " more (" << matches << " in total)" << std::endl;
+    }
+    while (searchAgain());
+}
+
+template <typename T>
+void HashTableManager<T>::enterDateRange()
+{
+    const int shown = 20; // matches listed before the rest are only counted
+    std::string firstInput, lastInput;
+    do
+    {
+        std::cin.ignore();
+        std::cout << "Enter the first date in [yyyy-mm-dd] format: ";
+        getline(std::cin, firstInput);
+        std::cout << "Enter the last date in [yyyy-mm-dd] format: ";
+        getline(std::cin, lastInput);
+        Date first, last;
+        if (first.parse(firstInput) && last.parse(lastInput))
         {
-            std::string name, y, m, d;
-            getline(inputFile, name);
-            getline(inputFile, y, '-');
-            getline(inputFile, m, '-');
-            getline(inputFile, d);
-            Date temp(y, m, d);
-            Person newPerson(name, temp); // creates new Person for each file entry
-            this->personTable.insert(newPerson, temp.formatDateToPrint());
+            int listed = 0;
+            int matches = forEachBornBetween(first, last, [&listed](T &person) {
+                if (listed++ < shown)
+                    std::cout << "{" << person.getBirthday() << ", " << person.getName() << "}" << std::endl;
+            });
+            if (matches == 0)
+                std::cout << "No entry born between [" << first << "] and [" << last << "] found in this data table" << std::endl;
+            else if (matches > shown)
+                std::cout << "... and " << matches - shown << " more (" << matches << " in total)" << std::endl;
         }
-        inputFile.close();
+        else std::cout << "*** invalid input - please use [yyyy-mm-dd] format ***" << std::endl;
+    }
+    while (searchAgain());
+}
+
+template <typename T>
+bool HashTableManager<T>::insert(T person)
+{
+    std::string key = person.getBirthday();
+    T *stored = this->personTable.emplace(std::move(key), std::move(person));
+    if (stored == nullptr) // the birthday does not fit the table's key policy
+        return false;
+    this->nameIndex.insert(stored->getName(), stored);
+    this->dateIndex.insert(stored->getDate().getPacked(), stored);
+    return true;
+}
+
+template <typename T>
+bool HashTableManager<T>::remove(const T &person)
+{
+    T *matched = nullptr; // the entry the table removes, only compared against the indexes' pointers once it is gone
+    std::uint32_t matchedDate = 0;
+    bool removed = this->personTable.removeIf(person.getBirthday(), [&person, &matched, &matchedDate](T &stored) {
+        if (stored.getName() != person.getName())
+            return false;
+        matched = &stored;
+        matchedDate = stored.getDate().getPacked();
         return true;
+    });
+    if (!removed)
+        return false;
+    this->nameIndex.remove(person.getName(), matched);
+    this->dateIndex.remove(matchedDate, matched);
+    return true;
+}
+
+template <typename T>
+template <typename Visitor>
+int HashTableManager<T>::forEachWithName(std::string_view name, Visitor visit)
+{
+    return this->nameIndex.forEach(name, [&visit](T *person) {visit(*person);});
+}
+
+template <typename T>
+template <typename Visitor>
+int HashTableManager<T>::forEachWithNamePrefix(std::string_view prefix, Visitor visit)
+{
+    return this->nameIndex.forEachPrefix(prefix, [&visit](T *person) {visit(*person);});
+}
+
+template <typename T>
+template <typename Visitor>
+int HashTableManager<T>::forEachBornBetween(Date first, Date last, Visitor visit)
+{
+    return this->dateIndex.forEachInRange(first.getPacked(), last.getPacked(), [&visit](std::uint32_t, T *person) {visit(*person);});
+}
+
+template <typename T>
+int HashTableManager<T>::countBornBetween(Date first, Date last)
+{
+    return this->dateIndex.countInRange(first.getPacked(), last.getPacked());
+}
+
+template <typename T>
+T* HashTableManager<T>::earliestBorn()
+{
+    T **person = this->dateIndex.first();
+    return person == nullptr ? nullptr : *person;
+}
+
+template <typename T>
+T* HashTableManager<T>::latestBorn()
+{
+    T **person = this->dateIndex.last();
+    return person == nullptr ? nullptr : *person;
+}
+
+template <typename T>
+const std::vector<std::size_t>& HashTableManager<T>::getInvalidDateLines()
+{return this->invalidDateLines;}
+
+template <typename T>
+int HashTableManager<T>::runBatch(std::string fileAddress, std::string queryAddress)
+{
+    std::ios::sync_with_stdio(false); // must happen before any stream is used
+    auto loadStart = std::chrono::steady_clock::now();
+    HashTableSnapshot<T> snapshot;
+    bool useSnapshot = HashTableSnapshot<T>::isSnapshot(fileAddress);
+    if (useSnapshot && !snapshot.open(fileAddress))
+    {
+        std::cerr << "*** SNAPSHOT FILE ERROR ***" << std::endl;
+        return 1;
+    }
+    if (!useSnapshot && !bulkLoad(fileAddress))
+    {
+        std::cerr << "*** INPUT FILE ERROR ***" << std::endl;
+        return 1;
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+    
+    std::ifstream queryFile;
+    std::istream *queries = &std::cin;
+    if (queryAddress != "-")
+    {
+        queryFile.open(queryAddress);
+        if (!queryFile)
+        {
+            std::cerr << "*** QUERY FILE ERROR ***" << std::endl;
+            return 1;
+        }
+        queries = &queryFile;
+    }
+    
+    const int window = 1024; // queries looked up together
+    const int INVALID_QUERY = -2; // result of a line that is not a date (searches only return an index or -1)
+    const std::size_t flushSize = 1 << 16;
+    std::vector<std::string> lines(window);
+    std::vector<std::string> keys(window, std::string(Date::FORMATTED_LENGTH, '0')); // valid lines in the yyyy-mm-dd form they are searched as
+    std::vector<int> keyLines(window); // the line each key came from
+    std::vector<int> keyResults(window);
+    std::vector<int> results(window);
+    std::string output;
+    output.reserve(flushSize + 256);
+    long long total = 0, found = 0, invalid = 0;
+    auto queryStart = std::chrono::steady_clock::now();
+    for (bool more = true; more; )
+    {
+        int filled = 0;
+        while (filled < window && getline(*queries, lines[filled]))
+        {
+            if (!lines[filled].empty() && lines[filled].back() == '\r') // files written on Windows
+                lines[filled].pop_back();
+            filled++;
+        }
+        more = (filled == window);
+        int keyCount = 0;
+        for (int i = 0; i < filled; i++)
+        {
+            Date queryDate;
+            if (!queryDate.parse(lines[i])) // invalid lines are answered without a lookup
+            {
+                results[i] = INVALID_QUERY;
+                continue;
+            }
+            queryDate.formatDateTo(&keys[keyCount][0]); // searched as a Date, the same as enterBirthday, so an out of range month or day defaults the way it did on load
+            keyLines[keyCount++] = i;
+        }
+        if (useSnapshot)
+            for (int k = 0; k < keyCount; k++)
+                keyResults[k] = snapshot.search(keys[k]);
+        else
+            this->personTable.searchBatch(keys.data(), keyCount, keyResults.data());
+        for (int k = 0; k < keyCount; k++)
+            results[keyLines[k]] = keyResults[k];
+        for (int i = 0; i < filled; i++)
+        {
+            output += lines[i];
+            if (results[i] == INVALID_QUERY)
+            {
+                output += "\tINVALID\n";
+                invalid++;
+            }
+            else if (results[i] == -1)
+                output += "\tNOT FOUND\n";
+            else
+            {
+                output += '\t';
+                output += useSnapshot ? snapshot[results[i]].getName() : this->personTable[results[i]].getName();
+                output += '\n';
+                found++;
+            }
+            if (output.size() >= flushSize)
+            {
+                std::fwrite(output.data(), 1, output.size(), stdout);
+                output.clear();
+            }
+        }
+        total += filled;
+    }
+    std::fwrite(output.data(), 1, output.size(), stdout);
+    std::fflush(stdout);
+    double querySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - queryStart).count();
+    
+    std::cerr << "Loaded: " << (useSnapshot ? snapshot.getCount() : this->personTable.getCount()) << " records in " << loadSeconds << " s" << (useSnapshot ? " (snapshot)" : "") << std::endl;
+    if (!this->invalidDateLines.empty())
+    {
+        const std::size_t listed = 10; // line numbers shown before the rest are only counted
+        std::cerr << "Invalid birthdates: " << this->invalidDateLines.size() << " (lines";
+        for (std::size_t i = 0; i < this->invalidDateLines.size() && i < listed; i++)
+            std::cerr << (i == 0 ? " " : ", ") << this->invalidDateLines[i];
+        std::cerr << (this->invalidDateLines.size() > listed ? ", ...)" : ")") << std::endl;
+    }
+    std::cerr << "Queries: " << total << " (" << found << " found, " << total - found - invalid << " not found, " << invalid << " invalid)" << std::endl;
+    std::cerr << "Query time: " << querySeconds << " s" << std::endl;
+    if (total > 0 && querySeconds > 0)
+    {
+        std::cerr << "Throughput: " << total / querySeconds << " queries/s" << std::endl;
+        std::cerr << "Average latency: " << querySeconds * 1e9 / total << " ns/query" << std::endl;
     }
-    return false;
+    HASHTABLE_RECORD(std::cerr << "Metrics: " << this->personTable.metricsSnapshot().toJson() << std::endl;)
+    return 0;
+}
+
+template <typename T>
+int HashTableManager<T>::runPipeline(std::string feedAddress, std::string queryAddress)
+{
+    std::ios::sync_with_stdio(false);
+    if (feedAddress == "-" && queryAddress == "-")
+    {
+        std::cerr << "*** FEED AND QUERIES CANNOT BOTH BE STANDARD INPUT ***" << std::endl;
+        return 1;
+    }
+    std::ifstream queryFile;
+    std::istream *queries = &std::cin;
+    if (queryAddress != "-")
+    {
+        queryFile.open(queryAddress);
+        if (!queryFile)
+        {
+            std::cerr << "*** QUERY FILE ERROR ***" << std::endl;
+            return 1;
+        }
+        queries = &queryFile;
+    }
+    IngestPipeline<T> pipeline;
+    if (!pipeline.start(feedAddress))
+    {
+        std::cerr << "*** FEED FILE ERROR ***" << std::endl;
+        return 1;
+    }
+    
+    const std::size_t flushSize = queryAddress == "-" ? 0 : 1 << 16; // someone typing queries wants each answer straight away
+    std::string line, output;
+    T person;
+    long long total = 0, found = 0, invalid = 0, duringIngest = 0;
+    double querySeconds = 0; // time spent answering, not waiting for the next query to arrive
+    while (getline(*queries, line))
+    {
+        auto queryStart = std::chrono::steady_clock::now();
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (pipeline.isIngesting())
+            duringIngest++;
+        output += line;
+        Date queryDate;
+        char key[Date::FORMATTED_LENGTH]; // the query in the yyyy-mm-dd form it is searched as, the same as runBatch
+        bool valid = queryDate.parse(line);
+        if (valid)
+            queryDate.formatDateTo(key);
+        if (!valid)
+        {
+            output += "\tINVALID\n";
+            invalid++;
+        }
+        else if (pipeline.search(std::string_view(key, Date::FORMATTED_LENGTH), person))
+        {
+            output += '\t';
+            output += person.getName();
+            output += '\n';
+            found++;
+        }
+        else output += "\tNOT FOUND\n";
+        querySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - queryStart).count();
+        if (output.size() >= flushSize)
+        {
+            std::fwrite(output.data(), 1, output.size(), stdout);
+            std::fflush(stdout);
+            output.clear();
+        }
+        total++;
+    }
+    std::fwrite(output.data(), 1, output.size(), stdout);
+    std::fflush(stdout);
+    pipeline.wait();
+    
+    double ingestSeconds = pipeline.getIngestSeconds();
+    LatencySummary visibility = pipeline.visibilityLatency();
+    std::cerr << "Ingested: " << pipeline.getIngestedCount() << " records (" << pipeline.getSkippedCount() << " skipped) in " << pipeline.getBatchCount() << " batches over " << ingestSeconds << " s" << std::endl;
+    if (pipeline.getIngestedCount() > 0)
+    {
+        std::cerr << "Ingest throughput: " << pipeline.getIngestedCount() / ingestSeconds << " records/s (" << pipeline.getIngestedCount() / pipeline.getInsertSeconds() << " records/s while inserting)" << std::endl;
+        std::cerr << "Visibility latency: p50 " << visibility.p50 / 1000 << " us, p99 " << visibility.p99 / 1000 << " us, p99.9 " << visibility.p999 / 1000 << " us, max " << visibility.max / 1000 << " us" << std::endl;
+    }
+    std::cerr << "Queries: " << total << " (" << found << " found, " << total - found - invalid << " not found, " << invalid << " invalid, " << duringIngest << " while ingesting)" << std::endl;
+    if (total > 0 && querySeconds > 0)
+        std::cerr << "Average query latency: " << querySeconds * 1e9 / total << " ns/query" << std::endl;
+    return 0;
+}
+
+template <typename T>
+int HashTableManager<T>::createSnapshot(std::string fileAddress, std::string snapshotAddress)
+{
+    if (!bulkLoad(fileAddress))
+    {
+        std::cerr << "*** INPUT FILE ERROR ***" << std::endl;
+        return 1;
+    }
+    if (!HashTableSnapshot<T>::save(this->personTable, snapshotAddress))
+    {
+        std::cerr << "*** SNAPSHOT FILE ERROR ***" << std::endl;
+        return 1;
+    }
+    std::cerr << "Saved: " << this->personTable.getCount() << " records to " << snapshotAddress << std::endl;
+    return 0;
+}
+
+template <typename T>
+bool HashTableManager<T>::readFromInputFile()
+{
+    return bulkLoad(this->inputFileAddress);
+}
+
+template <typename T>
+bool HashTableManager<T>::bulkLoad(std::string fileAddress)
+{
+    MappedFile inputFile;
+    if (!inputFile.open(fileAddress))
+        return false;
+    std::string_view contents = inputFile.getContents();
+    
+    std::size_t lines = 0; // memchr scans for line endings many bytes at a time
+    for (const char *position = contents.data(), *end = position + contents.size();
+         position != end && (position = static_cast<const char*>(std::memchr(position, '\n', std::size_t(end - position)))) != nullptr;
+         position++)
+        lines++;
+    this->personTable.reserve(int(this->personTable.getCount() + (lines + 2) / 2)); // two lines per record, last line may lack an ending
+    
+    std::vector<std::pair<std::uint32_t, T*>> sortedDates; // date index entries, sorted and built in one pass at the end
+    sortedDates.reserve((lines + 2) / 2);
+    const int chunk = 4096; // records whose dates are parsed together
+    std::vector<std::string_view> names, birthdates;
+    std::vector<std::size_t> dateLines; // line number of each birthdate in the chunk
+    std::vector<std::uint32_t> packedDates(chunk);
+    std::vector<int> invalidRows;
+    std::size_t offset = 0, lineNumber = 0;
+    while (offset < contents.size())
+    {
+        names.clear();
+        birthdates.clear();
+        dateLines.clear();
+        invalidRows.clear();
+        while (offset < contents.size() && int(names.size()) < chunk)
+        {
+            std::string_view name = nextLine(contents, offset);
+            std::string_view birthdate = nextLine(contents, offset);
+            lineNumber += 2;
+            if (name.empty() && birthdate.empty()) // blank lines (ie. at the end of the file)
+                continue;
+            names.push_back(name);
+            birthdates.push_back(birthdate);
+            dateLines.push_back(lineNumber);
+        }
+        DateParser::parseBatch(birthdates.data(), int(birthdates.size()), packedDates.data(), invalidRows);
+        for (int row : invalidRows)
+            this->invalidDateLines.push_back(dateLines[std::size_t(row)]);
+        for (std::size_t row = 0; row < names.size(); row++)
+        {
+            if (packedDates[row] == 0) // not in yyyy-mm-dd format
+                continue;
+            Date date = Date::fromPacked(packedDates[row]);
+            T *person = this->personTable.emplace(date.formatDateToPrint(), std::string(names[row]), date); // builds the Person inside its node, the name is allocated once
+            if (person == nullptr) // the key does not fit the table's key policy
+                continue;
+            this->nameIndex.insert(person->getName(), person);
+            sortedDates.emplace_back(date.getPacked(), person);
+        }
+    }
+    std::stable_sort(sortedDates.begin(), sortedDates.end(), [](const std::pair<std::uint32_t, T*> &first, const std::pair<std::uint32_t, T*> &second) {return first.first < second.first;}); // file order among equal dates
+    this->dateIndex.build(sortedDates);
+    return true;
+}
+
+template <typename T>
+std::string_view HashTableManager<T>::nextLine(std::string_view contents, std::size_t &offset)
+{
+    if (offset >= contents.size())
+        return std::string_view();
+    const char *start = contents.data() + offset;
+    const char *lineEnd = static_cast<const char*>(std::memchr(start, '\n', contents.size() - offset));
+    std::size_t length = lineEnd ? std::size_t(lineEnd - start) : contents.size() - offset;
+    offset += length + 1;
+    if (length > 0 && start[length - 1] == '\r') // files written on Windows
+        length--;
+    return std::string_view(start, length);
 }
 
 template <typename T>
@@ -143,13 +649,22 @@ void HashTableManager<T>::innerMenu(int choice)
     {
         case 1: enterBirthday();
             std::cin.ignore(); break;
-        case 2:
+        case 2: enterName();
+            std::cin.ignore(); break;
+        case 3: enterDateRange();
+            std::cin.ignore(); break;
+        case 4:
             std::cin.ignore();
-            this->personTable.stats(); break;
-        case 3:
+            this->personTable.stats();
+            std::cout << "Names Indexed: " << this->nameIndex.getCount() << " (" << this->nameIndex.getNodeCount() << " trie nodes)" << std::endl;
+            std::cout << "Birthdates Indexed: " << this->dateIndex.getCount() << " (" << this->dateIndex.getNodeCount() << " tree nodes, " << this->dateIndex.getHeight() << " levels)" << std::endl;
+            if (this->earliestBorn() != nullptr)
+                std::cout << "Birthdates From: " << this->earliestBorn()->getBirthday() << " to " << this->latestBorn()->getBirthday() << std::endl;
+            break;
+        case 5:
             std::cin.ignore();
             this->personTable.displayTable(); break;
-        case 4:
+        case 6:
             std::cin.ignore();
             std::cout << "Goodbye!" << std::endl; break;
     }
@@ -160,7 +675,7 @@ void HashTableManager<T>::pressEnterToContinue()
 {
     std::cout << "Press ENTER to continue...";
     std::cin.get();
-    system("clear");
+    std::cout << "\033[2J\033[H" << std::flush; // clear the terminal without starting a shell
 }
 
 
@@ -0,0 +1,234 @@
+/*
+ Hash Table Metrics
+ ==================
+ Low overhead counters that show how a HashTable behaves under real traffic: how far inserts and searches have to probe, how often and how long the table rehashes, and (sampled) how long single operations take.
+ Counting is compiled in only when HASHTABLE_METRICS is defined before the table headers are included (ie. -DHASHTABLE_METRICS). Without it the recording statements disappear and snapshots report enabled = false.
+ Counters are relaxed atomics, so tables shared by several reader threads (ConcurrentHashTable) can still record.
+ HashTableMetrics is the plain snapshot handed to callers; it can be dumped as JSON for monitoring.
+ */
+
+#ifndef HashTableMetrics_h
+#define HashTableMetrics_h
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(HASHTABLE_METRICS)
+#define HASHTABLE_RECORD(...) __VA_ARGS__
+#else
+#define HASHTABLE_RECORD(...)
+#endif
+
+#ifndef HASHTABLE_METRICS_SAMPLE_EVERY
+#define HASHTABLE_METRICS_SAMPLE_EVERY 64 // one operation in this many has its latency measured
+#endif
+
+enum PROBE_KIND{
+    INSERT_PROBE, HIT_PROBE, MISS_PROBE, PROBE_KIND_COUNT
+};
+
+enum TIMED_OPERATION{
+    INSERT_OPERATION, SEARCH_OPERATION, REMOVE_OPERATION, TIMED_OPERATION_COUNT
+};
+
+struct LatencySummary // percentiles of the sampled latencies of one operation, in nanoseconds
+{
+    long long samples = 0;
+    double p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;
+};
+
+struct HashTableMetrics
+{
+    static const int PROBE_BUCKETS = 32; // probe lengths 0 - 30, the last bucket holds 31 and longer
+
+    bool enabled = false; // false if the table was compiled without HASHTABLE_METRICS
+    std::vector<long long> insertProbes, hitProbes, missProbes; // number of operations that took each probe length
+    int maxProbeLength = 0; // longest probe sequence any operation has walked
+    long long rehashCount = 0;
+    double rehashTotalMilliseconds = 0, rehashMaxMilliseconds = 0;
+    LatencySummary insertLatency, searchLatency, removeLatency;
+
+    std::string toJson() const; // machine readable form of the snapshot
+};
+
+class MetricsRecorder
+{
+private:
+    static const int LATENCY_RING = 1024; // most recent samples kept per operation
+
+    std::atomic<long long> probes[PROBE_KIND_COUNT][HashTableMetrics::PROBE_BUCKETS];
+    std::atomic<int> maxProbe;
+    std::atomic<long long> rehashes, rehashNanoseconds, rehashMaxNanoseconds;
+    std::atomic<unsigned> sampleTick;
+    std::atomic<long long> sampleCount[TIMED_OPERATION_COUNT];
+    std::atomic<std::uint32_t> samples[TIMED_OPERATION_COUNT][LATENCY_RING];
+
+    LatencySummary summarize(TIMED_OPERATION) const;
+public:
+    MetricsRecorder();
+    void recordProbe(PROBE_KIND, int); // one operation of the given kind walked the given number of probe steps
+    void recordRehash(std::chrono::steady_clock::duration);
+    bool shouldSample(); // true for one call in HASHTABLE_METRICS_SAMPLE_EVERY
+    void recordLatency(TIMED_OPERATION, std::chrono::steady_clock::duration);
+    HashTableMetrics snapshot() const;
+
+    class Timer // measures the enclosing scope if this operation is sampled
+    {
+    private:
+        MetricsRecorder &recorder;
+        TIMED_OPERATION operation;
+        bool sampled;
+        std::chrono::steady_clock::time_point start;
+    public:
+        Timer(MetricsRecorder&, TIMED_OPERATION);
+        ~Timer();
+    };
+};
+
+/*
+ HashTableMetrics Functions
+ */
+
+inline std::string HashTableMetrics::toJson() const
+{
+    std::ostringstream json;
+    auto list = [&json](const std::vector<long long> &values) {
+        json << "[";
+        for (std::size_t i = 0; i < values.size(); i++)
+            json << (i ? "," : "") << values[i];
+        json << "]";
+    };
+    auto latency = [&json](const LatencySummary &summary) {
+        json << "{\"samples\":" << summary.samples << ",\"p50\":" << summary.p50 << ",\"p90\":" << summary.p90
+             << ",\"p99\":" << summary.p99 << ",\"p999\":" << summary.p999 << ",\"max\":" << summary.max << "}";
+    };
+    json << "{\"enabled\":" << (this->enabled ? "true" : "false");
+    json << ",\"insertProbes\":";
+    list(this->insertProbes);
+    json << ",\"hitProbes\":";
+    list(this->hitProbes);
+    json << ",\"missProbes\":";
+    list(this->missProbes);
+    json << ",\"maxProbeLength\":" << this->maxProbeLength;
+    json << ",\"rehashCount\":" << this->rehashCount;
+    json << ",\"rehashTotalMilliseconds\":" << this->rehashTotalMilliseconds;
+    json << ",\"rehashMaxMilliseconds\":" << this->rehashMaxMilliseconds;
+    json << ",\"latencyNanoseconds\":{\"insert\":";
+    latency(this->insertLatency);
+    json << ",\"search\":";
+    latency(this->searchLatency);
+    json << ",\"remove\":";
+    latency(this->removeLatency);
+    json << "}}";
+    return json.str();
+}
+
+/*
+ MetricsRecorder Functions
+ */
+
+inline MetricsRecorder::MetricsRecorder()
+{
+    for (auto &kind : this->probes)
+        for (auto &bucket : kind)
+            bucket.store(0, std::memory_order_relaxed);
+    for (auto &operation : this->samples)
+        for (auto &sample : operation)
+            sample.store(0, std::memory_order_relaxed);
+    for (auto &countOfSamples : this->sampleCount)
+        countOfSamples.store(0, std::memory_order_relaxed);
+    this->maxProbe.store(0, std::memory_order_relaxed);
+    this->rehashes.store(0, std::memory_order_relaxed);
+    this->rehashNanoseconds.store(0, std::memory_order_relaxed);
+    this->rehashMaxNanoseconds.store(0, std::memory_order_relaxed);
+    this->sampleTick.store(0, std::memory_order_relaxed);
+}
+
+inline void MetricsRecorder::recordProbe(PROBE_KIND kind, int length)
+{
+    int bucket = length < HashTableMetrics::PROBE_BUCKETS - 1 ? length : HashTableMetrics::PROBE_BUCKETS - 1;
+    this->probes[kind][bucket].fetch_add(1, std::memory_order_relaxed);
+    int longest = this->maxProbe.load(std::memory_order_relaxed);
+    while (length > longest && !this->maxProbe.compare_exchange_weak(longest, length, std::memory_order_relaxed))
+        ;
+}
+
+inline void MetricsRecorder::recordRehash(std::chrono::steady_clock::duration elapsed)
+{
+    long long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    this->rehashes.fetch_add(1, std::memory_order_relaxed);
+    this->rehashNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    long long longest = this->rehashMaxNanoseconds.load(std::memory_order_relaxed);
+    while (nanoseconds > longest && !this->rehashMaxNanoseconds.compare_exchange_weak(longest, nanoseconds, std::memory_order_relaxed))
+        ;
+}
+
+inline bool MetricsRecorder::shouldSample()
+{
+    return this->sampleTick.fetch_add(1, std::memory_order_relaxed) % HASHTABLE_METRICS_SAMPLE_EVERY == 0;
+}
+
+inline void MetricsRecorder::recordLatency(TIMED_OPERATION operation, std::chrono::steady_clock::duration elapsed)
+{
+    long long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    long long slot = this->sampleCount[operation].fetch_add(1, std::memory_order_relaxed) % LATENCY_RING;
+    this->samples[operation][slot].store(std::uint32_t(nanoseconds < 0xFFFFFFFFLL ? nanoseconds : 0xFFFFFFFFLL), std::memory_order_relaxed);
+}
+
+inline HashTableMetrics MetricsRecorder::snapshot() const
+{
+    HashTableMetrics metrics;
+    metrics.enabled = true;
+    std::vector<long long> *histograms[PROBE_KIND_COUNT] = {&metrics.insertProbes, &metrics.hitProbes, &metrics.missProbes};
+    for (int kind = 0; kind < PROBE_KIND_COUNT; kind++)
+        for (int bucket = 0; bucket < HashTableMetrics::PROBE_BUCKETS; bucket++)
+            histograms[kind]->push_back(this->probes[kind][bucket].load(std::memory_order_relaxed));
+    metrics.maxProbeLength = this->maxProbe.load(std::memory_order_relaxed);
+    metrics.rehashCount = this->rehashes.load(std::memory_order_relaxed);
+    metrics.rehashTotalMilliseconds = this->rehashNanoseconds.load(std::memory_order_relaxed) / 1e6;
+    metrics.rehashMaxMilliseconds = this->rehashMaxNanoseconds.load(std::memory_order_relaxed) / 1e6;
+    metrics.insertLatency = summarize(INSERT_OPERATION);
+    metrics.searchLatency = summarize(SEARCH_OPERATION);
+    metrics.removeLatency = summarize(REMOVE_OPERATION);
+    return metrics;
+}
+
+inline LatencySummary MetricsRecorder::summarize(TIMED_OPERATION operation) const
+{
+    LatencySummary summary;
+    summary.samples = this->sampleCount[operation].load(std::memory_order_relaxed);
+    std::vector<std::uint32_t> sorted;
+    long long kept = summary.samples < LATENCY_RING ? summary.samples : LATENCY_RING;
+    for (long long i = 0; i < kept; i++)
+        sorted.push_back(this->samples[operation][i].load(std::memory_order_relaxed));
+    if (sorted.empty())
+        return summary;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double fraction) {return double(sorted[std::size_t(fraction * (sorted.size() - 1))]);};
+    summary.p50 = percentile(0.5);
+    summary.p90 = percentile(0.9);
+    summary.p99 = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    summary.max = sorted.back();
+    return summary;
+}
+
+inline MetricsRecorder::Timer::Timer(MetricsRecorder &owner, TIMED_OPERATION timedOperation)
+    : recorder(owner), operation(timedOperation), sampled(owner.shouldSample())
+{
+    if (this->sampled)
+        this->start = std::chrono::steady_clock::now();
+}
+
+inline MetricsRecorder::Timer::~Timer()
+{
+    if (this->sampled)
+        this->recorder.recordLatency(this->operation, std::chrono::steady_clock::now() - this->start);
+}
+
+#endif /* HashTableMetrics_h */
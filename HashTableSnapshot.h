@@ -0,0 +1,339 @@
+/*
+ Hash Table Snapshot Class
+ This class saves a HashTable to a binary file and reopens it later without rebuilding the table.
+ The file holds a header, the table's slot array (one fixed size record per slot, in the same positions as in the table) and a pool with the bytes of every key and value.
+ Opening a snapshot only memory maps the file and checks the header, so startup time does not depend on the number of entries. Searches run directly against the mapped slot array with the same hash and probe sequence the table used, and values are decoded only when they are read.
+ The header carries a format version, a fingerprint of the hash policy (so a snapshot cannot be read with a different hash), its own checksum, and a checksum of the slot array and pool that verify() checks on demand.
+ Snapshots use the byte order of the machine that wrote them.
+
+ Values are turned into bytes by SnapshotCodec<T>, which is provided for Person and std::string.
+ */
+
+#ifndef HashTableSnapshot_h
+#define HashTableSnapshot_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "HashTable.h"
+#include "MappedFile.h"
+
+template <typename T>
+struct SnapshotCodec; // static void encode(T&, std::string&) appends the bytes of a value, static T decode(std::string_view) rebuilds it
+
+template <>
+struct SnapshotCodec<Person> // birthdate (10 characters) followed by the name
+{
+    static void encode(Person &person, std::string &bytes)
+    {
+        bytes += person.getBirthday();
+        bytes += person.getName();
+    }
+    static Person decode(std::string_view bytes)
+    {
+        if (bytes.size() < Date::FORMATTED_LENGTH) // damaged value
+            return Person();
+        Date birthDate;
+        birthDate.parse(bytes.substr(0, Date::FORMATTED_LENGTH));
+        return Person(std::string(bytes.substr(Date::FORMATTED_LENGTH)), birthDate);
+    }
+};
+
+template <>
+struct SnapshotCodec<std::string>
+{
+    static void encode(std::string &value, std::string &bytes) {bytes += value;}
+    static std::string decode(std::string_view bytes) {return std::string(bytes);}
+};
+
+struct SnapshotHeader
+{
+    char magic[8]; // identifies the file as a snapshot
+    std::uint32_t version;
+    std::uint32_t probingMode;
+    std::uint64_t slotCount, entryCount, poolBytes;
+    std::uint64_t hashFingerprint; // hash policy applied to a fixed string
+    std::uint64_t bodyChecksum; // slot array and pool
+    std::uint64_t headerChecksum; // every field above
+};
+
+struct SnapshotSlot
+{
+    std::uint64_t keyOffset, valueOffset; // into the pool
+    std::uint32_t keyLength, valueLength;
+    std::int32_t probeLength;
+    std::uint32_t state; // SLOT_EMPTY, SLOT_FULL or SLOT_TOMBSTONE
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header layout must not depend on the compiler");
+static_assert(sizeof(SnapshotSlot) == 32, "snapshot slot layout must not depend on the compiler");
+
+template <typename T, typename Hash = KeyHash>
+class HashTableSnapshot
+{
+private:
+    static constexpr char MAGIC[8] = {'H', 'T', 'S', 'N', 'A', 'P', '\0', '\1'};
+    static const std::uint32_t VERSION = 1;
+    enum SLOT_STATE{ SLOT_EMPTY, SLOT_FULL, SLOT_TOMBSTONE };
+
+    MappedFile file;
+    const SnapshotHeader *header = nullptr; // nullptr while nothing is open
+    const SnapshotSlot *slots = nullptr;
+    const char *pool = nullptr;
+    Hash hasher;
+
+    static std::uint64_t fingerprint(); // hash policy applied to a fixed string
+    static std::uint64_t checksum(std::string_view, std::string_view); // checksum of the slot array and pool
+    static std::uint64_t headerChecksum(const SnapshotHeader&);
+    bool slotInPool(const SnapshotSlot&); // true if the slot's key and value both lie inside the pool
+
+public:
+    /*
+     This method writes the given table to a snapshot file.
+     Pre: table, file address
+     Post: snapshot written
+     Return: true if the file could be written
+     */
+    template <typename KeyPolicy, typename Allocator>
+    static bool save(HashTable<T, Hash, KeyPolicy, Allocator>&, std::string);
+
+    static bool isSnapshot(std::string); // true if the file starts with the snapshot magic bytes
+
+    /*
+     This method maps a snapshot file and checks its header (magic bytes, version, hash policy, header checksum and sizes). Entries are not read or checksummed, see verify; instead each slot's offsets are checked against the pool whenever it is read, so a damaged body can make entries unfindable but never causes a read outside the mapping.
+     Pre: file address
+     Post: snapshot ready for searches if valid
+     Return: true if the snapshot could be opened
+     */
+    bool open(std::string);
+    void close();
+    bool verify(); // reads the whole snapshot and checks the slot array and pool against their checksum
+
+    /*
+     This method searches the mapped slot array for a key, probing exactly as the table did when it was saved. A slot whose key or value lies outside the pool is treated as not matching.
+     Pre: key
+     Post: none
+     Return: slot index if found, -1 if not
+     */
+    int search(std::string_view);
+    std::string_view getKey(int); // key stored in the slot at the given index (empty if it lies outside the pool)
+    std::string_view getValueBytes(int); // encoded value stored in the slot at the given index (empty if it lies outside the pool)
+    T operator[](int); // decoded value stored in the slot at the given index (T() if it lies outside the pool)
+    int getCount(); // entries in the snapshot
+    int getSize(); // slots in the snapshot
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T, typename Hash>
+template <typename KeyPolicy, typename Allocator>
+bool HashTableSnapshot<T, Hash>::save(HashTable<T, Hash, KeyPolicy, Allocator> &table, std::string fileAddress)
+{
+    table.finishResize(); // every entry in the one slot array that gets written
+    std::vector<SnapshotSlot> slotArray(std::size_t(table.size));
+    std::string bytes;
+    for (int index = 0; index < table.size; index++)
+    {
+        SnapshotSlot &slot = slotArray[std::size_t(index)];
+        std::memset(&slot, 0, sizeof(slot));
+        HashNode<T, KeyPolicy> *node = table.dataTable[index];
+        if (node == nullptr)
+            slot.state = SLOT_EMPTY;
+        else if (node == HashTable<T, Hash, KeyPolicy, Allocator>::tombstone())
+            slot.state = SLOT_TOMBSTONE;
+        else
+        {
+            slot.state = SLOT_FULL;
+            slot.probeLength = node->getProbeLength();
+            slot.keyOffset = bytes.size();
+            bytes += node->getKey();
+            slot.keyLength = std::uint32_t(bytes.size() - slot.keyOffset);
+            slot.valueOffset = bytes.size();
+            SnapshotCodec<T>::encode(node->getData(), bytes);
+            slot.valueLength = std::uint32_t(bytes.size() - slot.valueOffset);
+        }
+    }
+    std::string_view slotBytes(reinterpret_cast<const char*>(slotArray.data()), slotArray.size() * sizeof(SnapshotSlot));
+
+    SnapshotHeader fileHeader;
+    std::memset(&fileHeader, 0, sizeof(fileHeader));
+    std::memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+    fileHeader.version = VERSION;
+    fileHeader.probingMode = std::uint32_t(table.probingMode);
+    fileHeader.slotCount = std::uint64_t(table.size);
+    fileHeader.entryCount = std::uint64_t(table.count);
+    fileHeader.poolBytes = bytes.size();
+    fileHeader.hashFingerprint = fingerprint();
+    fileHeader.bodyChecksum = checksum(slotBytes, bytes);
+    fileHeader.headerChecksum = headerChecksum(fileHeader);
+
+    std::ofstream outputFile(fileAddress, std::ios::binary | std::ios::trunc);
+    if (!outputFile)
+        return false;
+    outputFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    outputFile.write(slotBytes.data(), std::streamsize(slotBytes.size()));
+    outputFile.write(bytes.data(), std::streamsize(bytes.size()));
+    return bool(outputFile);
+}
+
+template <typename T, typename Hash>
+bool HashTableSnapshot<T, Hash>::isSnapshot(std::string fileAddress)
+{
+    std::ifstream inputFile(fileAddress, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return inputFile.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+template <typename T, typename Hash>
+bool HashTableSnapshot<T, Hash>::open(std::string fileAddress)
+{
+    close();
+    if (!this->file.open(fileAddress))
+        return false;
+    std::string_view contents = this->file.getContents();
+    if (contents.size() < sizeof(SnapshotHeader))
+    {
+        close();
+        return false;
+    }
+    const SnapshotHeader *candidate = reinterpret_cast<const SnapshotHeader*>(contents.data()); // mappings are page aligned
+    bool valid = std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) == 0
+        && candidate->version == VERSION
+        && candidate->headerChecksum == headerChecksum(*candidate)
+        && candidate->hashFingerprint == fingerprint()
+        && candidate->slotCount <= std::uint64_t(contents.size() / sizeof(SnapshotSlot))
+        && sizeof(SnapshotHeader) + candidate->slotCount * sizeof(SnapshotSlot) + candidate->poolBytes == contents.size();
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+    this->header = candidate;
+    this->slots = reinterpret_cast<const SnapshotSlot*>(contents.data() + sizeof(SnapshotHeader));
+    this->pool = contents.data() + sizeof(SnapshotHeader) + candidate->slotCount * sizeof(SnapshotSlot);
+    return true;
+}
+
+template <typename T, typename Hash>
+void HashTableSnapshot<T, Hash>::close()
+{
+    this->file.close();
+    this->header = nullptr;
+    this->slots = nullptr;
+    this->pool = nullptr;
+}
+
+template <typename T, typename Hash>
+bool HashTableSnapshot<T, Hash>::verify()
+{
+    if (this->header == nullptr)
+        return false;
+    std::string_view slotBytes(reinterpret_cast<const char*>(this->slots), std::size_t(this->header->slotCount) * sizeof(SnapshotSlot));
+    std::string_view bytes(this->pool, std::size_t(this->header->poolBytes));
+    if (checksum(slotBytes, bytes) != this->header->bodyChecksum)
+        return false;
+    for (std::uint64_t index = 0; index < this->header->slotCount; index++) // offsets must stay inside the pool
+    {
+        if (this->slots[index].state == SLOT_FULL && !slotInPool(this->slots[index]))
+            return false;
+    }
+    return true;
+}
+
+template <typename T, typename Hash>
+int HashTableSnapshot<T, Hash>::search(std::string_view searchValue)
+{
+    if (this->header == nullptr || this->header->slotCount == 0)
+        return -1;
+    long long size = (long long)this->header->slotCount;
+    long long home = (long long)(this->hasher(searchValue) % this->header->slotCount);
+    for (long long step = 0; step < size; step++) // same probe sequence as HashTable::searchFrom
+    {
+        int index = int((home + step * step) % size);
+        const SnapshotSlot &slot = this->slots[index];
+        if (slot.state == SLOT_EMPTY)
+            break;
+        if (slot.state == SLOT_FULL)
+        {
+            if (slotInPool(slot) && getKey(index) == searchValue)
+                return index;
+            if (this->header->probingMode == ROBIN_HOOD_PROBING && slot.probeLength < step)
+                break;
+        }
+    }
+    return -1;
+}
+
+template <typename T, typename Hash>
+std::string_view HashTableSnapshot<T, Hash>::getKey(int index)
+{
+    if (!slotInPool(this->slots[index]))
+        return std::string_view();
+    return std::string_view(this->pool + this->slots[index].keyOffset, this->slots[index].keyLength);
+}
+
+template <typename T, typename Hash>
+std::string_view HashTableSnapshot<T, Hash>::getValueBytes(int index)
+{
+    if (!slotInPool(this->slots[index]))
+        return std::string_view();
+    return std::string_view(this->pool + this->slots[index].valueOffset, this->slots[index].valueLength);
+}
+
+template <typename T, typename Hash>
+T HashTableSnapshot<T, Hash>::operator[](int index)
+{
+    if (!slotInPool(this->slots[index]))
+        return T();
+    return SnapshotCodec<T>::decode(getValueBytes(index));
+}
+
+template <typename T, typename Hash>
+int HashTableSnapshot<T, Hash>::getCount()
+{return this->header ? int(this->header->entryCount) : 0;}
+
+template <typename T, typename Hash>
+int HashTableSnapshot<T, Hash>::getSize()
+{return this->header ? int(this->header->slotCount) : 0;}
+
+/*
+ Private Functions
+ */
+
+template <typename T, typename Hash>
+std::uint64_t HashTableSnapshot<T, Hash>::fingerprint()
+{
+    return Hash()(std::string_view("HashTableSnapshot fingerprint 1961-01-10"));
+}
+
+template <typename T, typename Hash>
+std::uint64_t HashTableSnapshot<T, Hash>::checksum(std::string_view slotBytes, std::string_view bytes)
+{
+    KeyHash bodyHash;
+    return KeyHash::mix(bodyHash(slotBytes) * 0x9e3779b97f4a7c15ULL + bodyHash(bytes));
+}
+
+/*
+ Written so that neither sum can overflow, since a damaged offset may be anything.
+ */
+template <typename T, typename Hash>
+bool HashTableSnapshot<T, Hash>::slotInPool(const SnapshotSlot &slot)
+{
+    std::uint64_t poolBytes = this->header->poolBytes;
+    return slot.keyOffset <= poolBytes && slot.keyLength <= poolBytes - slot.keyOffset
+        && slot.valueOffset <= poolBytes && slot.valueLength <= poolBytes - slot.valueOffset;
+}
+
+template <typename T, typename Hash>
+std::uint64_t HashTableSnapshot<T, Hash>::headerChecksum(const SnapshotHeader &fileHeader)
+{
+    return KeyHash()(std::string_view(reinterpret_cast<const char*>(&fileHeader), offsetof(SnapshotHeader, headerChecksum)));
+}
+
+#endif /* HashTableSnapshot_h */
@@ -0,0 +1,307 @@
+/*
+ Ingest Pipeline Class
+ This class keeps a table up to date from a continuous feed of records (a name line followed by a yyyy-mm-dd line, the same format HashTableManager loads) while other threads query it.
+ A producer thread reads the feed (a pipe, a FIFO, standard input, or a regular file that is still being written to) and parses it into batches of records. Each batch is handed to an inserter thread through a bounded lock free queue (SpscQueue), and the inserter adds the records to a ConcurrentHashTable, which queries can search at any time.
+ A regular file is followed the way tail -f follows it: reaching its end only means nothing new has arrived yet, and the feed is over once the file has not grown for the idle timeout. Pipes are over when their writer closes them.
+ Every record is timed from the moment its line was read to the moment it could be found in the table (its visibility latency). A batch is handed over as soon as a read has been parsed, rather than only once it is full, so a slow trickle of updates is not held back waiting for more.
+ */
+
+#ifndef IngestPipeline_h
+#define IngestPipeline_h
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ConcurrentHashTable.h"
+#include "Date.h"
+#include "HashTableMetrics.h"
+#include "SpscQueue.h"
+
+template <typename T>
+class IngestPipeline
+{
+private:
+    struct Record
+    {
+        std::string name;
+        Date date;
+    };
+    struct Batch // records parsed from one read of the feed
+    {
+        std::vector<Record> records;
+        std::chrono::steady_clock::time_point arrived; // when the read returned
+    };
+    static constexpr int BATCH_RECORDS = 1024; // a batch is handed over once it holds this many records
+    static constexpr int READ_SIZE = 1 << 16; // bytes requested from the feed at a time
+    static constexpr int QUEUE_BATCHES = 64; // batches the producer may run ahead of the inserter
+    static constexpr int LATENCY_RING = 1 << 20; // most recent visibility latencies kept
+    static constexpr int POLL_MILLISECONDS = 10; // pause between looks at a followed file that has stopped growing
+
+    ConcurrentHashTable<T> table;
+    SpscQueue<Batch> queue;
+    std::thread producer, inserter;
+    int descriptor = -1; // feed being read
+    bool follow = false; // true if the feed is a regular file that may still grow
+    int idleMilliseconds; // how long a followed file may stay unchanged before the feed is over
+    std::string pendingName; // name line of a record whose date line has not been read yet
+    bool haveName = false;
+    std::atomic<long long> ingested{0}, skipped{0}, batches{0}; // records visible in the table, records dropped for a malformed date, batches handed over
+    std::atomic<bool> finished{false}; // set once the inserter has added the last record
+    std::chrono::steady_clock::time_point startTime, finishTime; // finishTime is when the last batch was inserted, not when the feed was found to be over
+    double insertSeconds = 0; // time the inserter spent inserting (the rest it waited for the producer)
+    std::vector<std::uint32_t> visibility; // ring of visibility latencies in nanoseconds, written by the inserter only
+    long long visibilityCount = 0;
+
+    void produce(); // producer thread: reads and parses the feed until it is over, then closes the queue
+    void consume(); // inserter thread: adds every queued batch to the table
+    void takeLine(std::string_view, Batch&); // adds one line of the feed to the batch being built
+    void handOver(Batch&); // queues the batch (if it holds anything) and starts a new one
+
+public:
+    /*
+     Constructor.
+     Pre: idle timeout in milliseconds, after which a followed file that has stopped growing counts as finished
+     Post: pipeline ready to start
+     */
+    explicit IngestPipeline(int = 1000);
+    IngestPipeline(const IngestPipeline&) = delete;
+    IngestPipeline& operator=(const IngestPipeline&) = delete;
+
+    /*
+     This method opens the feed and starts the producer and inserter threads. Opening a FIFO waits until something opens it for writing.
+     Pre: feed address, or "-" for standard input
+     Post: feed being ingested in the background
+     Return: true if the feed could be opened
+     */
+    bool start(std::string);
+    void wait(); // blocks until the feed is over and every record has been inserted
+
+    /*
+     This method searches the table as it stands, while ingestion carries on. A record is found as soon as the inserter has added it.
+     Pre: string key (yyyy-mm-dd), T to receive the value
+     Post: value copied into the given T if found
+     Return: true if found
+     */
+    bool search(std::string_view, T&);
+    bool isIngesting(); // true until the last record of the feed has been inserted
+    long long getIngestedCount(); // records inserted so far
+    long long getSkippedCount(); // records dropped because their date line was not in yyyy-mm-dd format
+    long long getBatchCount(); // batches handed from the producer to the inserter
+    double getIngestSeconds(); // time from start until the last record was inserted (or until now if still running), without the idle timeout that ends a followed file
+    double getInsertSeconds(); // time the inserter was busy inserting, only complete once the feed is over
+    LatencySummary visibilityLatency(); // percentiles of the most recent visibility latencies, only to be read once the feed is over
+
+    ~IngestPipeline();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T>
+IngestPipeline<T>::IngestPipeline(int idleTimeout) : queue(QUEUE_BATCHES)
+{
+    this->idleMilliseconds = idleTimeout < 0 ? 0 : idleTimeout;
+}
+
+template <typename T>
+bool IngestPipeline<T>::start(std::string feedAddress)
+{
+    this->descriptor = feedAddress == "-" ? STDIN_FILENO : ::open(feedAddress.c_str(), O_RDONLY);
+    if (this->descriptor == -1)
+        return false;
+    struct stat feedInfo;
+    this->follow = fstat(this->descriptor, &feedInfo) == 0 && S_ISREG(feedInfo.st_mode);
+    this->visibility.assign(LATENCY_RING, 0);
+    this->startTime = std::chrono::steady_clock::now();
+    this->producer = std::thread(&IngestPipeline::produce, this);
+    this->inserter = std::thread(&IngestPipeline::consume, this);
+    return true;
+}
+
+template <typename T>
+void IngestPipeline<T>::wait()
+{
+    if (this->producer.joinable())
+        this->producer.join();
+    if (this->inserter.joinable())
+        this->inserter.join();
+}
+
+template <typename T>
+bool IngestPipeline<T>::search(std::string_view searchValue, T &result)
+{
+    return this->table.search(searchValue, result);
+}
+
+template <typename T>
+bool IngestPipeline<T>::isIngesting()
+{
+    return !this->finished.load(std::memory_order_acquire);
+}
+
+template <typename T>
+long long IngestPipeline<T>::getIngestedCount()
+{return this->ingested.load(std::memory_order_relaxed);}
+
+template <typename T>
+long long IngestPipeline<T>::getSkippedCount()
+{return this->skipped.load(std::memory_order_relaxed);}
+
+template <typename T>
+long long IngestPipeline<T>::getBatchCount()
+{return this->batches.load(std::memory_order_relaxed);}
+
+template <typename T>
+double IngestPipeline<T>::getIngestSeconds()
+{
+    auto end = isIngesting() ? std::chrono::steady_clock::now() : this->finishTime;
+    return std::chrono::duration<double>(end - this->startTime).count();
+}
+
+template <typename T>
+double IngestPipeline<T>::getInsertSeconds()
+{return this->insertSeconds;}
+
+template <typename T>
+LatencySummary IngestPipeline<T>::visibilityLatency()
+{
+    LatencySummary summary;
+    summary.samples = this->visibilityCount;
+    std::size_t kept = std::size_t(this->visibilityCount < LATENCY_RING ? this->visibilityCount : LATENCY_RING);
+    if (kept == 0)
+        return summary;
+    std::vector<std::uint32_t> sorted(this->visibility.begin(), this->visibility.begin() + kept);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double fraction) {return double(sorted[std::size_t(fraction * double(sorted.size() - 1))]);};
+    summary.p50 = percentile(0.5);
+    summary.p90 = percentile(0.9);
+    summary.p99 = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    summary.max = double(sorted.back());
+    return summary;
+}
+
+template <typename T>
+IngestPipeline<T>::~IngestPipeline()
+{
+    wait();
+    if (this->descriptor > STDIN_FILENO)
+        ::close(this->descriptor);
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T>
+void IngestPipeline<T>::produce()
+{
+    std::vector<char> chunk(READ_SIZE);
+    std::string partial; // start of a line whose end has not been read yet
+    Batch batch;
+    auto lastGrowth = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        ssize_t received = ::read(this->descriptor, chunk.data(), chunk.size());
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received < 0)
+            break;
+        if (received == 0) // end of a pipe, or (for now) of a followed file
+        {
+            if (!this->follow || std::chrono::steady_clock::now() - lastGrowth > std::chrono::milliseconds(this->idleMilliseconds))
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MILLISECONDS));
+            continue;
+        }
+        lastGrowth = batch.arrived = std::chrono::steady_clock::now();
+        partial.append(chunk.data(), std::size_t(received));
+        std::size_t lineStart = 0, lineEnd;
+        while ((lineEnd = partial.find('\n', lineStart)) != std::string::npos)
+        {
+            takeLine(std::string_view(partial).substr(lineStart, lineEnd - lineStart), batch);
+            lineStart = lineEnd + 1;
+        }
+        partial.erase(0, lineStart);
+        handOver(batch); // whatever this read completed becomes visible without waiting for the next one
+    }
+    if (!partial.empty()) // last line of the feed had no line ending
+    {
+        batch.arrived = std::chrono::steady_clock::now();
+        takeLine(partial, batch);
+        handOver(batch);
+    }
+    this->queue.close();
+}
+
+template <typename T>
+void IngestPipeline<T>::takeLine(std::string_view line, Batch &batch)
+{
+    if (!line.empty() && line.back() == '\r') // files written on Windows
+        line.remove_suffix(1);
+    if (!this->haveName)
+    {
+        this->pendingName.assign(line.data(), line.size());
+        this->haveName = true;
+        return;
+    }
+    this->haveName = false;
+    if (this->pendingName.empty() && line.empty()) // blank lines (ie. between updates)
+        return;
+    Date date;
+    if (!date.parse(line))
+    {
+        this->skipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    batch.records.push_back(Record{std::move(this->pendingName), date});
+    this->pendingName.clear();
+    if (int(batch.records.size()) >= BATCH_RECORDS)
+        handOver(batch);
+}
+
+template <typename T>
+void IngestPipeline<T>::handOver(Batch &batch)
+{
+    if (batch.records.empty())
+        return;
+    auto arrived = batch.arrived;
+    this->queue.push(batch);
+    this->batches.fetch_add(1, std::memory_order_relaxed);
+    batch = Batch();
+    batch.arrived = arrived; // the rest of the same read
+    batch.records.reserve(BATCH_RECORDS);
+}
+
+template <typename T>
+void IngestPipeline<T>::consume()
+{
+    Batch batch;
+    this->finishTime = this->startTime; // an empty feed took no time to ingest
+    while (this->queue.pop(batch))
+    {
+        auto insertStart = std::chrono::steady_clock::now();
+        for (Record &record : batch.records)
+        {
+            this->table.emplace(record.date.formatDateToPrint(), std::move(record.name), record.date);
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - batch.arrived).count();
+            this->visibility[std::size_t(this->visibilityCount++ % LATENCY_RING)] = std::uint32_t(latency < 0xFFFFFFFFLL ? latency : 0xFFFFFFFFLL);
+        }
+        this->ingested.fetch_add((long long)batch.records.size(), std::memory_order_release);
+        this->finishTime = std::chrono::steady_clock::now(); // the idle timeout a followed file waits out after this is not ingest time
+        this->insertSeconds += std::chrono::duration<double>(this->finishTime - insertStart).count();
+    }
+    this->finished.store(true, std::memory_order_release);
+}
+
+#endif /* IngestPipeline_h */
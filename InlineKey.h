@@ -0,0 +1,73 @@
+/*
+ Inline Key Class
+ This class holds a short string key inside the object itself, in a fixed size character array, instead of on the heap like std::string.
+ Keys up to the capacity given as the template parameter fit, and every operation is constexpr, so inline keys can be built and compared at compile time.
+ */
+
+#ifndef InlineKey_h
+#define InlineKey_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+template <std::size_t Capacity>
+class InlineKey
+{
+private:
+    static_assert(Capacity > 0 && Capacity < 256, "the length of an inline key is stored in one byte");
+
+    char bytes[Capacity] = {}; // key characters, unused ones stay zero
+    std::uint8_t length = 0;
+
+public:
+    constexpr InlineKey() {}
+    constexpr explicit InlineKey(std::string_view); // copies the key, which must fit (see fits)
+
+    static constexpr bool fits(std::string_view); // true if the key is no longer than the capacity
+    constexpr std::string_view view() const; // the key's characters
+    constexpr std::size_t size() const;
+    constexpr bool operator==(std::string_view) const;
+    constexpr bool operator!=(std::string_view) const;
+};
+
+template <std::size_t Capacity>
+constexpr InlineKey<Capacity>::InlineKey(std::string_view key)
+{
+    std::size_t copied = fits(key) ? key.size() : Capacity; // an oversized key is cut short rather than overrunning
+    for (std::size_t index = 0; index < copied; index++)
+        this->bytes[index] = key[index];
+    this->length = std::uint8_t(copied);
+}
+
+template <std::size_t Capacity>
+constexpr bool InlineKey<Capacity>::fits(std::string_view key)
+{
+    return key.size() <= Capacity;
+}
+
+template <std::size_t Capacity>
+constexpr std::string_view InlineKey<Capacity>::view() const
+{
+    return std::string_view(this->bytes, this->length);
+}
+
+template <std::size_t Capacity>
+constexpr std::size_t InlineKey<Capacity>::size() const
+{
+    return this->length;
+}
+
+template <std::size_t Capacity>
+constexpr bool InlineKey<Capacity>::operator==(std::string_view key) const
+{
+    return view() == key;
+}
+
+template <std::size_t Capacity>
+constexpr bool InlineKey<Capacity>::operator!=(std::string_view key) const
+{
+    return view() != key;
+}
+
+#endif /* InlineKey_h */
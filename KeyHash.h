@@ -0,0 +1,77 @@
+/*
+ Key Hash Policies
+ =================
+ These function objects turn a key of type string into a 64 bit hash value, and are used as the Hash template parameter of HashTable.
+ KeyHash is the default: it mixes the key 8 bytes at a time so that keys differing in any single character land in unrelated buckets. It is constexpr, so tables built at compile time (FixedHashTable) hash the same way.
+ BirthdateDigitHash keeps the original digit-root birthdate hash available for comparison (it can only produce 0 - 9).
+ */
+#ifndef KeyHash_h
+#define KeyHash_h
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "StringAssistant.h"
+
+struct KeyHash
+{
+    constexpr std::uint64_t operator()(std::string_view) const; // hashes the bytes of the key
+    static constexpr std::uint64_t mix(std::uint64_t); // avalanches every input bit across the whole output
+    static constexpr std::uint64_t loadWord(const char*); // 8 bytes as a little endian word (the compiler turns this into a single load)
+    static constexpr std::uint64_t loadPartialWord(const char*, std::size_t); // fewer than 8 bytes as a little endian word
+};
+
+struct BirthdateDigitHash
+{
+    std::uint64_t operator()(std::string_view) const; // digit root of the date, 0 - 9
+};
+
+constexpr std::uint64_t KeyHash::mix(std::uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+constexpr std::uint64_t KeyHash::loadWord(const char *bytes)
+{
+    return std::uint64_t((unsigned char)bytes[0]) | std::uint64_t((unsigned char)bytes[1]) << 8 |
+           std::uint64_t((unsigned char)bytes[2]) << 16 | std::uint64_t((unsigned char)bytes[3]) << 24 |
+           std::uint64_t((unsigned char)bytes[4]) << 32 | std::uint64_t((unsigned char)bytes[5]) << 40 |
+           std::uint64_t((unsigned char)bytes[6]) << 48 | std::uint64_t((unsigned char)bytes[7]) << 56;
+}
+
+constexpr std::uint64_t KeyHash::loadPartialWord(const char *bytes, std::size_t length)
+{
+    std::uint64_t word = 0;
+    for (std::size_t index = 0; index < length; index++)
+        word |= std::uint64_t((unsigned char)bytes[index]) << (8 * index);
+    return word;
+}
+
+constexpr std::uint64_t KeyHash::operator()(std::string_view key) const
+{
+    const char *bytes = key.data();
+    std::size_t length = key.length();
+    std::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (length * 0xbf58476d1ce4e5b9ULL);
+    while (length >= 8) // whole 8 byte words first
+    {
+        hash = (hash ^ mix(loadWord(bytes))) * 0x9e3779b97f4a7c15ULL;
+        bytes += 8;
+        length -= 8;
+    }
+    if (length > 0) // remaining 1 - 7 bytes
+        hash = (hash ^ mix(loadPartialWord(bytes, length))) * 0x9e3779b97f4a7c15ULL;
+    return mix(hash);
+}
+
+inline std::uint64_t BirthdateDigitHash::operator()(std::string_view key) const
+{
+    return StringAssistant::hashStringBirthdate(std::string(key));
+}
+
+#endif /* KeyHash_h */
@@ -0,0 +1,117 @@
+/*
+ Key Policies
+ ============
+ These structs decide how HashTable stores the key inside each node and how a searched key is compared against it, and are used as its KeyPolicy template parameter. A policy provides:
+   Stored           the type held by every node
+   Probe            the form a searched key is turned into, once per lookup, before any node is compared
+   fits(key)        true if the key can be stored (a table refuses to insert a key that does not fit, and never finds one)
+   store(key)       builds the stored form from the inserted std::string
+   probe(key)       builds the probe form from a searched key
+   equal(stored, probe)
+   view(stored)     the stored key's characters
+ StringKeyPolicy is the default: every node holds a std::string, so keys of any length work.
+ PackedKeyPolicy stores keys of up to 15 characters inline in a 16 byte PackedKey, so a node holds no std::string at all and two keys are compared with one 128 bit compare instead of a length check and a memcmp. It suits tables whose keys all have the same short length, like the birthdate table.
+ The hash is always taken from the key's characters, so both policies place the same key in the same slot.
+ */
+
+#ifndef KeyPolicy_h
+#define KeyPolicy_h
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+class PackedKey // up to 15 characters and their length in 16 bytes: characters first, zero padded, length in the last byte
+{
+private:
+    char bytes[16] = {}; // only byte aligned, so a node holding one needs no padding around it
+
+public:
+    static const std::size_t CAPACITY = 15;
+
+    PackedKey() {}
+    explicit PackedKey(std::string_view); // copies the key, which must fit (see fits)
+
+    static bool fits(std::string_view); // true if the key is no longer than CAPACITY
+    std::string_view view() const; // the key's characters
+    std::size_t size() const;
+    bool operator==(const PackedKey&) const; // compares all 16 bytes at once (the length byte included)
+    bool operator!=(const PackedKey&) const;
+};
+
+struct StringKeyPolicy
+{
+    using Stored = std::string;
+    using Probe = std::string_view;
+    static bool fits(std::string_view) {return true;}
+    static Stored store(std::string key) {return key;}
+    static Probe probe(std::string_view key) {return key;}
+    static bool equal(const Stored &stored, const Probe &key) {return stored == key;}
+    static std::string_view view(const Stored &stored) {return stored;}
+};
+
+struct PackedKeyPolicy
+{
+    using Stored = PackedKey;
+    using Probe = PackedKey;
+    static bool fits(std::string_view key) {return PackedKey::fits(key);}
+    static Stored store(std::string key) {return PackedKey(key);}
+    static Probe probe(std::string_view key) {return PackedKey(key);}
+    static bool equal(const Stored &stored, const Probe &key) {return stored == key;}
+    static std::string_view view(const Stored &stored) {return stored.view();}
+};
+
+/*
+ Keys of 4 or more characters are copied as two fixed size pieces that overlap in the middle (ie. bytes 0 - 7 and 2 - 9 of a 10 character key), so the copy is a few plain loads and stores instead of a call to memcpy with a variable length, and nothing past the end of the key is read.
+ */
+inline PackedKey::PackedKey(std::string_view key)
+{
+    std::size_t length = fits(key) ? key.size() : CAPACITY; // an oversized key is cut short rather than overrunning
+    const char *source = key.data();
+    if (length >= 8)
+    {
+        std::memcpy(this->bytes, source, 8);
+        std::memcpy(this->bytes + length - 8, source + length - 8, 8);
+    }
+    else if (length >= 4)
+    {
+        std::memcpy(this->bytes, source, 4);
+        std::memcpy(this->bytes + length - 4, source + length - 4, 4);
+    }
+    else
+        for (std::size_t index = 0; index < length; index++)
+            this->bytes[index] = source[index];
+    this->bytes[CAPACITY] = char(length);
+}
+
+inline bool PackedKey::fits(std::string_view key)
+{
+    return key.size() <= CAPACITY;
+}
+
+inline std::string_view PackedKey::view() const
+{
+    return std::string_view(this->bytes, size());
+}
+
+inline std::size_t PackedKey::size() const
+{
+    return std::size_t((unsigned char)this->bytes[CAPACITY]);
+}
+
+inline bool PackedKey::operator==(const PackedKey &other) const
+{
+    std::uint64_t mine[2], theirs[2]; // copied out as words, which the compiler turns into plain loads
+    std::memcpy(mine, this->bytes, 16);
+    std::memcpy(theirs, other.bytes, 16);
+    return ((mine[0] ^ theirs[0]) | (mine[1] ^ theirs[1])) == 0;
+}
+
+inline bool PackedKey::operator!=(const PackedKey &other) const
+{
+    return !(*this == other);
+}
+
+#endif /* KeyPolicy_h */
@@ -0,0 +1,86 @@
+/*
+ Mapped File Class
+ This class maps a whole file into memory (read only) so that its contents can be read in place as one block of characters, without copying them into strings.
+ The mapping is released when the object is closed or destroyed.
+ */
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile
+{
+private:
+    const char *data = nullptr; // start of the mapping, nullptr when nothing is mapped
+    std::size_t length = 0; // bytes mapped
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /*
+     This method maps the file at the given address, replacing any previous mapping. An empty file opens successfully with no contents.
+     Pre: file address
+     Post: file contents available through getContents
+     Return: true if the file could be opened and mapped
+     */
+    bool open(std::string);
+    void close(); // releases the mapping
+    std::string_view getContents(); // the whole file
+    ~MappedFile();
+};
+
+bool MappedFile::open(std::string fileAddress)
+{
+    close();
+    int descriptor = ::open(fileAddress.c_str(), O_RDONLY);
+    if (descriptor == -1)
+        return false;
+    struct stat fileInfo;
+    if (fstat(descriptor, &fileInfo) == -1 || !S_ISREG(fileInfo.st_mode))
+    {
+        ::close(descriptor);
+        return false;
+    }
+    if (fileInfo.st_size > 0)
+    {
+        void *mapping = mmap(nullptr, std::size_t(fileInfo.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(descriptor);
+            return false;
+        }
+        madvise(mapping, std::size_t(fileInfo.st_size), MADV_SEQUENTIAL); // read front to back once
+        this->data = static_cast<const char*>(mapping);
+        this->length = std::size_t(fileInfo.st_size);
+    }
+    ::close(descriptor); // the mapping stays valid after the descriptor is closed
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (this->data != nullptr)
+        munmap(const_cast<char*>(this->data), this->length);
+    this->data = nullptr;
+    this->length = 0;
+}
+
+std::string_view MappedFile::getContents()
+{
+    return std::string_view(this->data, this->length);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#endif /* MappedFile_h */
@@ -0,0 +1,148 @@
+/*
+ Node Allocators
+ ===============
+ These classes decide where a HashTable gets the memory for its nodes. A table takes the allocator as a template parameter (for the same key policy as the table, see KeyPolicy.h) and only ever calls:
+   create(args...)  builds a HashNode from the given constructor arguments and returns it
+   destroy(node)    destroys a node created by this allocator and takes its memory back
+   reserve(n)       prepares room for n more nodes
+   release()        gives back every bit of memory at once; any node not trivially destructible must have been destroyed first
+   RELEASES_IN_BULK true if release frees the nodes' memory itself, so trivially destructible nodes need not be destroyed one by one
+
+ HeapNodeAllocator gives every node its own new / delete, as the table originally did.
+ NodeArena carves nodes out of large slabs. Removed nodes go onto a free list and are reused by the next create, and release hands back the slabs in a handful of calls no matter how many nodes were made. Nodes never move, so pointers into them stay valid until they are destroyed.
+ */
+
+#ifndef NodeAllocator_h
+#define NodeAllocator_h
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include "HashNode.h"
+
+template <typename T, typename KeyPolicy = StringKeyPolicy>
+class HeapNodeAllocator
+{
+public:
+    static const bool RELEASES_IN_BULK = false;
+
+    template <typename... Args>
+    HashNode<T, KeyPolicy>* create(Args&&... args) {return new HashNode<T, KeyPolicy>(std::forward<Args>(args)...);}
+    void destroy(HashNode<T, KeyPolicy> *node) {delete node;}
+    void reserve(int) {}
+    void release() {}
+};
+
+template <typename T, typename KeyPolicy = StringKeyPolicy>
+class NodeArena
+{
+private:
+    union Block // one node's worth of memory, which links into the free list while unused
+    {
+        Block *nextFree;
+        alignas(HashNode<T, KeyPolicy>) unsigned char node[sizeof(HashNode<T, KeyPolicy>)];
+    };
+    static const int FIRST_SLAB = 64; // blocks in the first slab, each slab after that doubles up to MAX_SLAB
+    static const int MAX_SLAB = 1 << 16;
+
+    std::vector<Block*> slabs; // every slab allocated so far
+    Block *freeList = nullptr; // destroyed nodes waiting to be reused
+    Block *next = nullptr, *end = nullptr; // unused part of the newest slab
+    int nextSlab = FIRST_SLAB; // blocks in the next slab to allocate
+
+    void addSlab(int); // allocates a slab of the given number of blocks and makes it the newest
+
+public:
+    static const bool RELEASES_IN_BULK = true;
+
+    NodeArena() {}
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /*
+     This method builds a node in the most recently freed block, or in the next unused block of the newest slab, adding a slab when both are used up.
+     Pre: arguments for HashNode's constructor
+     Post: node constructed in arena memory
+     Return: the new node
+     */
+    template <typename... Args>
+    HashNode<T, KeyPolicy>* create(Args&&...);
+    void destroy(HashNode<T, KeyPolicy>*); // runs the node's destructor and puts its block on the free list
+    void reserve(int); // makes sure the given number of nodes can be created without another slab allocation
+    void release(); // frees every slab (nodes must already be destroyed unless trivially destructible)
+
+    ~NodeArena();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T, typename KeyPolicy>
+template <typename... Args>
+HashNode<T, KeyPolicy>* NodeArena<T, KeyPolicy>::create(Args&&... args)
+{
+    Block *block = this->freeList;
+    if (block != nullptr)
+        this->freeList = block->nextFree;
+    else
+    {
+        if (this->next == this->end)
+            addSlab(this->nextSlab);
+        block = this->next++;
+    }
+    return new (block->node) HashNode<T, KeyPolicy>(std::forward<Args>(args)...);
+}
+
+template <typename T, typename KeyPolicy>
+void NodeArena<T, KeyPolicy>::destroy(HashNode<T, KeyPolicy> *node)
+{
+    node->~HashNode();
+    Block *block = reinterpret_cast<Block*>(node);
+    block->nextFree = this->freeList;
+    this->freeList = block;
+}
+
+template <typename T, typename KeyPolicy>
+void NodeArena<T, KeyPolicy>::reserve(int nodes)
+{
+    long long available = this->end - this->next;
+    for (Block *block = this->freeList; block != nullptr && available < nodes; block = block->nextFree)
+        available++;
+    if (available < nodes)
+        addSlab(int(nodes - available)); // one slab for all of them, the leftover of the current slab is skipped
+}
+
+template <typename T, typename KeyPolicy>
+void NodeArena<T, KeyPolicy>::release()
+{
+    for (Block *slab : this->slabs)
+        ::operator delete(slab);
+    this->slabs.clear();
+    this->freeList = this->next = this->end = nullptr;
+    this->nextSlab = FIRST_SLAB;
+}
+
+template <typename T, typename KeyPolicy>
+NodeArena<T, KeyPolicy>::~NodeArena()
+{
+    release();
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T, typename KeyPolicy>
+void NodeArena<T, KeyPolicy>::addSlab(int blocks)
+{
+    Block *slab = static_cast<Block*>(::operator new(sizeof(Block) * std::size_t(blocks)));
+    this->slabs.push_back(slab);
+    this->next = slab;
+    this->end = slab + blocks;
+    if (this->nextSlab < MAX_SLAB)
+        this->nextSlab *= 2;
+}
+
+#endif /* NodeAllocator_h */
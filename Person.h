@@ -3,17 +3,20 @@
  ============
  This class serves to mimic a person with a name and birthdate.
  It has the ability to compare based on name and birth dates using a boolean variable that must be changed when needed.
+ Persons can be moved as well as copied, so a name built once (ie. while loading a file) is handed on to the table without being copied again. Comparisons take the other Person by reference.
  */
 #ifndef Person_h
 #define Person_h
 
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <utility>
 #include "Date.h"
 
 class Person;
-std::ofstream& operator<<(std::ofstream& outputFile, Person&);
-std::ostream& operator<<(std::ostream& output, Person&);
+std::ofstream& operator<<(std::ofstream& outputFile, const Person&);
+std::ostream& operator<<(std::ostream& output, const Person&);
 
 class Person
 {
@@ -23,18 +26,22 @@ private:
     Date birthDate;
 public:
     Person();
-    Person(std::string, Date);
-    Person(std::string);
-    std::string getName();
-    std::string getBirthday();
+    Person(std::string, Date); // the name is moved in
+    explicit Person(std::string); // name only, explicit so a string is never silently turned into a Person
+    Person(const Person&) = default;
+    Person(Person&&) noexcept = default;
+    Person& operator=(const Person&) = default;
+    Person& operator=(Person&&) noexcept = default;
+    const std::string& getName() const;
+    std::string getBirthday() const;
+    Date getDate() const;
     
     
     void setName(std::string);
-    void setDate(Date&);
+    void setDate(Date);
     
-    void operator=(Person);
-    bool operator<(Person);
-    bool operator==(Person);
+    bool operator<(const Person&) const;
+    bool operator==(const Person&) const;
     static void sortByName();
     static void sortByDate();
     
@@ -44,42 +51,39 @@ bool Person::byName = true;
 
 Person::Person()
 {
-    this->name = "";
 }
 
-Person::Person(std::string name)
+Person::Person(std::string givenName) : name(std::move(givenName))
 {
-    this->name = name;
 }
 
-Person::Person(std::string name, Date date)
+Person::Person(std::string givenName, Date date) : name(std::move(givenName)), birthDate(date)
 {
-    this->name = name;
-    this->birthDate = date;
 }
 
-std::string Person::getName(){return this->name;}
-std::string Person::getBirthday()
+const std::string& Person::getName() const {return this->name;}
+std::string Person::getBirthday() const
 {
     return this->birthDate.formatDateToPrint();
 }
+Date Person::getDate() const {return this->birthDate;}
 
-void Person::setName(std::string newName){this->name = newName;}
-void Person::setDate(Date &newDate){this->birthDate = newDate;}
+void Person::setName(std::string newName){this->name = std::move(newName);}
+void Person::setDate(Date newDate){this->birthDate = newDate;}
 
-std::ofstream& operator<<(std::ofstream& outputFile, Person& person)
+std::ofstream& operator<<(std::ofstream& outputFile, const Person& person)
 {
     outputFile << person.getName() << "\t" << person.getBirthday();
     return outputFile;
 }
 
-std::ostream& operator<<(std::ostream& output, Person& person)
+std::ostream& operator<<(std::ostream& output, const Person& person)
 {
     output << person.getName();
     return output;
 }
 
-bool Person::operator<(Person otherPerson)
+bool Person::operator<(const Person &otherPerson) const
 {
     if (byName)
     {
@@ -91,18 +95,12 @@ bool Person::operator<(Person otherPerson)
     }
 }
 
-void Person::operator=(Person otherPerson)
-{
-    this->name = otherPerson.name;
-    this->birthDate = otherPerson.birthDate;
-}
-
-bool Person::operator==(Person otherPerson)
+bool Person::operator==(const Person &otherPerson) const
 {
     if (byName)
-        return (this->name == otherPerson.getName());
+        return (this->name == otherPerson.name);
     else
-        return (this->birthDate.formatDateToPrint() == otherPerson.getBirthday());
+        return (this->birthDate == otherPerson.birthDate);
 }
 
 void Person::sortByName(){byName = true;}
@@ -0,0 +1,127 @@
+/*
+ Person Generator Class
+ This class produces synthetic Person records for benchmarks and load tests.
+ Birthdates are drawn from a pool of consecutive calendar days starting at 1900-01-01. The skew controls how often the same birthdates come up: with a skew of 1 every date in the pool is equally likely, and larger values make the first dates of the pool far more popular (a skew of 3 puts about half of all records on the first 1/8 of the pool).
+ Names are combinations of common first and last names, so many records share a name prefix.
+ The same seed always produces the same sequence.
+ */
+
+#ifndef PersonGenerator_h
+#define PersonGenerator_h
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include "Date.h"
+#include "Person.h"
+
+class PersonGenerator
+{
+private:
+    std::mt19937_64 random;
+    int dateCount; // days in the birthdate pool
+    double skew; // exponent applied to the uniform draw, 1 means uniform
+    int serial = 0; // records generated so far, appended to names to tell them apart
+    static Date dateFromDayNumber(int); // calendar date the given number of days after 1900-01-01
+public:
+    static const int MAX_DATES = 365 * 6000; // pool stays below year 8000, clear of missingDate
+    /*
+     Constructor.
+     Pre: seed, number of distinct birthdates (consecutive days from 1900-01-01, at most MAX_DATES), skew (1 or more)
+     Post: generator ready
+     */
+    PersonGenerator(std::uint64_t = 1, int = 365 * 100, double = 1);
+
+    Date nextDate(); // birthdate drawn from the pool
+    Person nextPerson(); // new Person with a generated name and birthdate
+    static Date missingDate(int); // birthdate guaranteed to be outside every pool (year 9000 onwards), for lookups that should miss
+
+    /*
+     This method writes the given number of records to a file in the same format HashTableManager reads (a name line followed by a yyyy-mm-dd line).
+     Pre: file address, number of records
+     Post: file written
+     Return: true if the file could be written
+     */
+    bool writeRoster(std::string, long long);
+};
+
+PersonGenerator::PersonGenerator(std::uint64_t seed, int dates, double skewExponent) : random(seed)
+{
+    this->dateCount = dates < 1 ? 1 : (dates > MAX_DATES ? MAX_DATES : dates);
+    this->skew = skewExponent < 1 ? 1 : skewExponent;
+}
+
+Date PersonGenerator::nextDate()
+{
+    double draw = std::uniform_real_distribution<double>(0, 1)(this->random);
+    int day = int(this->dateCount * std::pow(draw, this->skew));
+    return dateFromDayNumber(day < this->dateCount ? day : this->dateCount - 1);
+}
+
+Person PersonGenerator::nextPerson()
+{
+    static const char *firstNames[] = {"The", "Mary", "John", "Patricia", "Robert", "Jennifer", "Michael", "Linda", "David", "Elizabeth", "James", "Susan", "Maria", "Wei", "Ahmed", "Olga"};
+    static const char *lastNames[] = {"Smith", "Johnson", "Garcia", "Brown", "Nguyen", "Kim", "Patel", "Rossi", "Muller", "Cohen", "Silva", "Ivanova", "Doors", "Beatles", "Jones", "Lee"};
+    std::uint64_t bits = this->random();
+    std::string name = firstNames[bits % 16];
+    name += ' ';
+    name += lastNames[(bits >> 8) % 16];
+    name += ' ';
+    name += std::to_string(this->serial++);
+    return Person(std::move(name), nextDate());
+}
+
+Date PersonGenerator::missingDate(int n)
+{
+    return dateFromDayNumber(366 * 7100 + n % (365 * 800)); // years 9000 - 9800
+}
+
+bool PersonGenerator::writeRoster(std::string fileAddress, long long records)
+{
+    std::ofstream outputFile(fileAddress, std::ios::binary);
+    if (!outputFile)
+        return false;
+    std::string buffer;
+    for (long long record = 0; record < records; record++)
+    {
+        Person person = nextPerson();
+        buffer += person.getName();
+        buffer += '\n';
+        buffer += person.getBirthday();
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20))
+        {
+            outputFile.write(buffer.data(), std::streamsize(buffer.size()));
+            buffer.clear();
+        }
+    }
+    outputFile.write(buffer.data(), std::streamsize(buffer.size()));
+    return bool(outputFile);
+}
+
+/*
+ Private Functions
+ */
+
+Date PersonGenerator::dateFromDayNumber(int dayNumber) // civil calendar conversion (March based years make leap days fall at the end)
+{
+    long long days = dayNumber + 693901; // days since 0000-03-01
+    long long era = days / 146097;
+    long long dayOfEra = days - era * 146097;
+    long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long long monthIndex = (5 * dayOfYear + 2) / 153;
+    int day = int(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    int month = int(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    int year = int(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+    char text[32];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, day);
+    Date date;
+    date.parse(std::string_view(text, Date::FORMATTED_LENGTH));
+    return date;
+}
+
+#endif /* PersonGenerator_h */
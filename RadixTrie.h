@@ -0,0 +1,313 @@
+/*
+ Radix Trie Class
+ This class maps string keys to values and answers both exact and prefix queries.
+ It is a compressed trie: every edge is labelled with a whole run of characters rather than a single one, so a chain of nodes with one child each is stored as a single node. Keys that share a beginning (ie. "The Doors" and "The Beatles") share the nodes for it, and each key's characters are stored once at most.
+ A key may hold any number of values (duplicate names are common), and a specific value can be removed again.
+ Children are kept sorted by their first character, so every query visits keys in alphabetical order.
+ Values are stored as given, so the trie is meant to hold small handles (ie. pointers into another structure) rather than the records themselves.
+ */
+
+#ifndef RadixTrie_h
+#define RadixTrie_h
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+template <typename V>
+class RadixTrie
+{
+private:
+    struct TrieNode
+    {
+        std::string label; // characters on the edge from the parent to this node
+        std::vector<TrieNode*> children; // sorted by the first character of their label
+        std::vector<V> values; // values whose key ends at this node
+    };
+
+    TrieNode *root; // empty label, holds the values of the empty key
+    int count = 0, nodeCount = 1; // values stored, and nodes allocated (root included)
+
+    static unsigned char firstChar(const TrieNode*); // first character of a (non root) node's label
+    static std::size_t commonPrefix(std::string_view, std::string_view); // number of leading characters the two strings share
+    static typename std::vector<TrieNode*>::iterator childFor(TrieNode*, unsigned char); // child whose label starts with the given character, or the position it would take
+    TrieNode* findNode(std::string_view); // node where the key ends, nullptr if the key is not present
+    TrieNode* findPrefixNode(std::string_view); // highest node whose keys all start with the prefix, nullptr if none do
+    void mergeWithOnlyChild(TrieNode*); // absorbs a node's single child into it, once the node itself holds no values
+    template <typename Visitor>
+    void visitSubtree(TrieNode*, Visitor&, int&); // visits the values of a node and everything below it, in key order
+
+public:
+    RadixTrie(); // Constructor, empty trie
+    RadixTrie(const RadixTrie&) = delete;
+    RadixTrie& operator=(const RadixTrie&) = delete;
+
+    /*
+     This method adds a value under the given key. The trie walks down the edges matching the key, splits an edge where the key leaves it part way, and adds a single new node for whatever part of the key is left over.
+     Pre: key, value
+     Post: value stored under the key
+     Return: none
+     */
+    void insert(std::string_view, V);
+
+    /*
+     This method removes one value from the given key. A node left with no values is deleted if it has no children, or merged into its only child, so the trie stays as compact as if the value had never been inserted.
+     Pre: key, value to remove (compared with ==)
+     Post: value removed if found
+     Return: true if removed
+     */
+    bool remove(std::string_view, const V&);
+
+    /*
+     This method calls the visitor on every value stored under exactly the given key.
+     Pre: key, function taking V&
+     Post: visitor called once per value
+     Return: number of values visited
+     */
+    template <typename Visitor>
+    int forEach(std::string_view, Visitor);
+
+    /*
+     This method calls the visitor on every value whose key starts with the given prefix, in alphabetical order of key. Only the nodes below the prefix are visited, so the cost depends on the number of matches rather than on the size of the trie.
+     Pre: prefix (an empty prefix matches every key), function taking V&
+     Post: visitor called once per matching value
+     Return: number of values visited
+     */
+    template <typename Visitor>
+    int forEachPrefix(std::string_view, Visitor);
+
+    int countKey(std::string_view); // number of values stored under exactly the key
+    int getCount(); // values stored
+    int getNodeCount(); // nodes allocated, root included
+
+    ~RadixTrie();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename V>
+RadixTrie<V>::RadixTrie()
+{
+    this->root = new TrieNode();
+}
+
+template <typename V>
+void RadixTrie<V>::insert(std::string_view key, V value)
+{
+    TrieNode *node = this->root;
+    while (!key.empty())
+    {
+        auto position = childFor(node, (unsigned char)key[0]);
+        if (position == node->children.end() || firstChar(*position) != (unsigned char)key[0]) // nothing shares the next character
+        {
+            TrieNode *leaf = new TrieNode();
+            leaf->label = std::string(key);
+            node->children.insert(position, leaf);
+            this->nodeCount++;
+            node = leaf;
+            break;
+        }
+        TrieNode *child = *position;
+        std::size_t shared = commonPrefix(child->label, key);
+        if (shared < child->label.size()) // the key leaves the edge part way, split it there
+        {
+            TrieNode *middle = new TrieNode();
+            middle->label = child->label.substr(0, shared);
+            child->label.erase(0, shared);
+            middle->children.push_back(child);
+            *position = middle;
+            this->nodeCount++;
+            child = middle;
+        }
+        node = child;
+        key.remove_prefix(shared);
+    }
+    node->values.push_back(std::move(value));
+    this->count++;
+}
+
+template <typename V>
+bool RadixTrie<V>::remove(std::string_view key, const V &value)
+{
+    TrieNode *parent = nullptr, *node = this->root;
+    while (!key.empty())
+    {
+        auto position = childFor(node, (unsigned char)key[0]);
+        if (position == node->children.end() || firstChar(*position) != (unsigned char)key[0])
+            return false;
+        TrieNode *child = *position;
+        if (key.size() < child->label.size() || key.compare(0, child->label.size(), child->label) != 0)
+            return false;
+        key.remove_prefix(child->label.size());
+        parent = node;
+        node = child;
+    }
+    auto found = std::find(node->values.begin(), node->values.end(), value);
+    if (found == node->values.end())
+        return false;
+    node->values.erase(found);
+    this->count--;
+
+    if (node == this->root || !node->values.empty())
+        return true;
+    if (node->children.empty()) // nothing left below, unlink the node
+    {
+        parent->children.erase(childFor(parent, firstChar(node)));
+        delete node;
+        this->nodeCount--;
+        if (parent != this->root && parent->values.empty() && parent->children.size() == 1)
+            mergeWithOnlyChild(parent);
+    }
+    else if (node->children.size() == 1)
+        mergeWithOnlyChild(node);
+    return true;
+}
+
+template <typename V>
+template <typename Visitor>
+int RadixTrie<V>::forEach(std::string_view key, Visitor visit)
+{
+    TrieNode *node = findNode(key);
+    if (node == nullptr)
+        return 0;
+    for (V &value : node->values)
+        visit(value);
+    return int(node->values.size());
+}
+
+template <typename V>
+template <typename Visitor>
+int RadixTrie<V>::forEachPrefix(std::string_view prefix, Visitor visit)
+{
+    int visited = 0;
+    TrieNode *node = findPrefixNode(prefix);
+    if (node != nullptr)
+        visitSubtree(node, visit, visited);
+    return visited;
+}
+
+template <typename V>
+int RadixTrie<V>::countKey(std::string_view key)
+{
+    TrieNode *node = findNode(key);
+    return node == nullptr ? 0 : int(node->values.size());
+}
+
+template <typename V>
+int RadixTrie<V>::getCount()
+{return this->count;}
+
+template <typename V>
+int RadixTrie<V>::getNodeCount()
+{return this->nodeCount;}
+
+template <typename V>
+RadixTrie<V>::~RadixTrie()
+{
+    std::vector<TrieNode*> pending(1, this->root); // explicit stack, long keys cannot overflow the call stack
+    while (!pending.empty())
+    {
+        TrieNode *node = pending.back();
+        pending.pop_back();
+        pending.insert(pending.end(), node->children.begin(), node->children.end());
+        delete node;
+    }
+}
+
+/*
+ Private Functions
+ */
+
+template <typename V>
+unsigned char RadixTrie<V>::firstChar(const TrieNode *node)
+{
+    return (unsigned char)node->label[0];
+}
+
+template <typename V>
+std::size_t RadixTrie<V>::commonPrefix(std::string_view first, std::string_view second)
+{
+    std::size_t length = first.size() < second.size() ? first.size() : second.size(), shared = 0;
+    while (shared < length && first[shared] == second[shared])
+        shared++;
+    return shared;
+}
+
+template <typename V>
+typename std::vector<typename RadixTrie<V>::TrieNode*>::iterator RadixTrie<V>::childFor(TrieNode *node, unsigned char character)
+{
+    return std::lower_bound(node->children.begin(), node->children.end(), character,
+                            [](const TrieNode *child, unsigned char wanted) {return firstChar(child) < wanted;});
+}
+
+template <typename V>
+typename RadixTrie<V>::TrieNode* RadixTrie<V>::findNode(std::string_view key)
+{
+    TrieNode *node = this->root;
+    while (!key.empty())
+    {
+        auto position = childFor(node, (unsigned char)key[0]);
+        if (position == node->children.end() || firstChar(*position) != (unsigned char)key[0])
+            return nullptr;
+        node = *position;
+        if (key.size() < node->label.size() || key.compare(0, node->label.size(), node->label) != 0)
+            return nullptr;
+        key.remove_prefix(node->label.size());
+    }
+    return node;
+}
+
+template <typename V>
+typename RadixTrie<V>::TrieNode* RadixTrie<V>::findPrefixNode(std::string_view prefix)
+{
+    TrieNode *node = this->root;
+    while (!prefix.empty())
+    {
+        auto position = childFor(node, (unsigned char)prefix[0]);
+        if (position == node->children.end() || firstChar(*position) != (unsigned char)prefix[0])
+            return nullptr;
+        node = *position;
+        std::size_t shared = commonPrefix(node->label, prefix);
+        if (shared == prefix.size()) // the prefix ends on this edge, every key below starts with it
+            return node;
+        if (shared < node->label.size()) // the prefix leaves the edge, no key starts with it
+            return nullptr;
+        prefix.remove_prefix(shared);
+    }
+    return node;
+}
+
+template <typename V>
+void RadixTrie<V>::mergeWithOnlyChild(TrieNode *node)
+{
+    TrieNode *child = node->children[0];
+    node->label += child->label;
+    node->values = std::move(child->values);
+    node->children = std::move(child->children);
+    delete child;
+    this->nodeCount--;
+}
+
+template <typename V>
+template <typename Visitor>
+void RadixTrie<V>::visitSubtree(TrieNode *node, Visitor &visit, int &visited)
+{
+    std::vector<TrieNode*> pending(1, node); // children pushed in reverse, so they come off the stack in key order
+    while (!pending.empty())
+    {
+        TrieNode *current = pending.back();
+        pending.pop_back();
+        for (V &value : current->values)
+        {
+            visit(value);
+            visited++;
+        }
+        pending.insert(pending.end(), current->children.rbegin(), current->children.rend());
+    }
+}
+
+#endif /* RadixTrie_h */
@@ -0,0 +1,198 @@
+/*
+ Single Producer Single Consumer Queue Class
+ This class is a bounded queue that hands items from exactly one producer thread to exactly one consumer thread without any locks.
+ Items live in a ring buffer whose capacity is a power of two. The producer only ever writes the tail index and the consumer only ever writes the head index, so each side publishes its progress with a single release store and the other side picks it up with an acquire load. Each side also keeps a private copy of the other side's index and only reloads it when the queue looks full (or empty), so in steady state the two threads do not touch each other's cache lines at all.
+ A full queue makes the producer wait, which keeps a fast producer from running arbitrarily far ahead of the consumer (backpressure). Once the producer is done it closes the queue, and the consumer drains what is left.
+ A consumer waiting in pop polls the queue briefly (SPIN_LIMIT times) and then goes to sleep on a condition variable, so a queue that stays empty for a while (ie. a quiet feed) does not keep a core busy. The producer only takes the lock to wake it when it has said it is asleep, so a busy queue never touches the lock.
+ */
+
+#ifndef SpscQueue_h
+#define SpscQueue_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+template <typename T>
+class SpscQueue
+{
+private:
+    T *items; // ring buffer
+    std::size_t mask; // capacity - 1
+
+    alignas(64) std::atomic<std::size_t> head{0}; // next item to pop, written by the consumer only
+    std::size_t cachedTail = 0; // consumer's last view of tail
+    alignas(64) std::atomic<std::size_t> tail{0}; // next free slot, written by the producer only
+    std::size_t cachedHead = 0; // producer's last view of head
+    alignas(64) std::atomic<bool> closed{false};
+    std::atomic<bool> consumerAsleep{false}; // set while the consumer is (about to be) waiting on wakeUp
+    std::mutex wakeMutex;
+    std::condition_variable wakeUp; // signalled by push once the consumer is asleep, and by close
+    static const int SPIN_LIMIT = 64; // empty polls (each followed by a yield) before pop goes to sleep
+
+    bool hasItems(); // true if the consumer has something to pop
+    void wakeConsumer(); // called by the producer after publishing an item
+
+public:
+    /*
+     Constructor.
+     Pre: capacity (rounded up to a power of two)
+     Post: empty, open queue
+     */
+    explicit SpscQueue(std::size_t = 1024);
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /*
+     This method moves an item into the queue if there is room. Only the producer thread may call it.
+     Pre: item
+     Post: item queued (and moved from) if there was room, untouched otherwise
+     Return: true if queued
+     */
+    bool tryPush(T&);
+    void push(T&); // queues the item, yielding while the queue is full
+
+    /*
+     This method moves the oldest item out of the queue if there is one. Only the consumer thread may call it.
+     Pre: T to receive the item
+     Post: item moved into the given T if the queue was not empty
+     Return: true if an item was taken
+     */
+    bool tryPop(T&);
+
+    /*
+     This method takes the oldest item, waiting until one arrives: it polls for a short while, then sleeps until push or close wakes it. It only gives up once the queue has been closed and every item before the close has been taken.
+     Pre: T to receive the item
+     Post: item moved into the given T if one was taken
+     Return: true if an item was taken, false if the queue is closed and drained
+     */
+    bool pop(T&);
+    void close(); // called by the producer once it has pushed its last item
+    bool isClosed() const;
+    std::size_t getCapacity() const;
+
+    ~SpscQueue();
+};
+
+/*
+ Public Functions
+ */
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t requestedCapacity)
+{
+    std::size_t capacity = 2;
+    while (capacity < requestedCapacity)
+        capacity *= 2;
+    this->items = new T[capacity];
+    this->mask = capacity - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPush(T &item)
+{
+    std::size_t position = this->tail.load(std::memory_order_relaxed); // only this thread writes tail
+    if (position - this->cachedHead > this->mask) // looks full, see how far the consumer has got
+    {
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        if (position - this->cachedHead > this->mask)
+            return false;
+    }
+    this->items[position & this->mask] = std::move(item);
+    this->tail.store(position + 1, std::memory_order_seq_cst); // publishes the item (seq_cst rather than release, see wakeConsumer)
+    wakeConsumer();
+    return true;
+}
+
+template <typename T>
+void SpscQueue<T>::push(T &item)
+{
+    while (!tryPush(item))
+        std::this_thread::yield();
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPop(T &item)
+{
+    std::size_t position = this->head.load(std::memory_order_relaxed); // only this thread writes head
+    if (position == this->cachedTail) // looks empty, see whether the producer has added more
+    {
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        if (position == this->cachedTail)
+            return false;
+    }
+    item = std::move(this->items[position & this->mask]);
+    this->head.store(position + 1, std::memory_order_release); // hands the slot back to the producer
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::pop(T &item)
+{
+    for (int spin = 0; spin < SPIN_LIMIT; spin++)
+    {
+        if (tryPop(item))
+            return true;
+        if (isClosed()) // close comes after the last push, so one more look finds anything pushed before it
+            return tryPop(item);
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(this->wakeMutex);
+    this->consumerAsleep.store(true, std::memory_order_seq_cst); // see wakeConsumer
+    this->wakeUp.wait(lock, [this]() {return hasItems() || isClosed();});
+    this->consumerAsleep.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    return tryPop(item); // false only if the queue was closed with nothing left
+}
+
+template <typename T>
+void SpscQueue<T>::close()
+{
+    this->closed.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(this->wakeMutex);
+    this->wakeUp.notify_all();
+}
+
+template <typename T>
+bool SpscQueue<T>::isClosed() const
+{
+    return this->closed.load(std::memory_order_acquire);
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::getCapacity() const
+{return this->mask + 1;}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue()
+{
+    delete[] this->items;
+}
+
+/*
+ Private Functions
+ */
+
+template <typename T>
+bool SpscQueue<T>::hasItems()
+{
+    return this->head.load(std::memory_order_relaxed) != this->tail.load(std::memory_order_seq_cst);
+}
+
+/*
+ The producer stores tail and then loads consumerAsleep, while a consumer going to sleep stores consumerAsleep and then loads tail. With all four accesses seq_cst, at least one side sees the other's store: either the producer sees the consumer is asleep and wakes it, or the consumer sees the item and does not wait. Taking the lock before notifying means a consumer that is asleep is either still checking its wait condition (and will see the item) or already waiting (and gets the notification), so a wake up is never lost.
+ */
+template <typename T>
+void SpscQueue<T>::wakeConsumer()
+{
+    if (this->consumerAsleep.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(this->wakeMutex);
+        this->wakeUp.notify_one();
+    }
+}
+
+#endif /* SpscQueue_h */
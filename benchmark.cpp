@@ -0,0 +1,732 @@
+//
+//  benchmark.cpp
+//  CIS22C_Lab6
+//
+//  Times HashTable operations on generated data.
+//  Build with optimizations: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+//
+//  Usage: benchmark [--min rows] [--max rows] [--dates distinct birthdates] [--skew exponent]
+//    Row counts go from min to max by powers of ten (default 1000 to 1000000).
+//    A skew of 1 spreads rows evenly over the dates, larger values pile them onto fewer dates.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/resource.h>
+#include "ConcurrentHashTable.h"
+#include "DateParser.h"
+#include "FixedHashTable.h"
+#include "FlatHashTable.h"
+#include "HashMultiTable.h"
+#include "HashTable.h"
+#include "HashTableManager.h"
+#include "PersonGenerator.h"
+
+using namespace std;
+
+static string dateKey(int n) // distinct yyyy-mm-dd key for every n below 28 * 12 * 9000
+{
+    char key[24];
+    snprintf(key, sizeof(key), "%04d-%02d-%02d", 1000 + n / (28 * 12), n / 28 % 12 + 1, n % 28 + 1);
+    return key;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static long peakMemoryMegabytes() // peak resident set size of the whole process so far
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return long(usage.ru_maxrss / (1024 * 1024)); // bytes on macOS
+#else
+    return long(usage.ru_maxrss / 1024); // kilobytes on Linux
+#endif
+}
+
+static int failedChecks = 0; // benchmarks whose results disagreed with their reference, main exits with 1 if there are any
+
+static const char* verdict(bool agrees) // marker for the end of a benchmark line, counting a disagreement as a failed check
+{
+    if (!agrees)
+        failedChecks++;
+    return agrees ? "" : "  [RESULTS DIFFER]";
+}
+
+static void report(const char *operation, long long rows, long long operations, double seconds)
+{
+    printf("%-34s %12lld rows %10.1f ns/op %14.0f ops/s %8ld MB peak RSS\n", operation, rows,
+           seconds * 1e9 / operations, operations / seconds, peakMemoryMegabytes());
+}
+
+/*
+ Times insert, search (hits and misses), a rehash and remove on HashTable, the same operations on FlatHashTable, and on std::unordered_multimap as a baseline, grouped inserts on HashMultiTable, and HashTableManager loading a roster file of the same rows.
+ Hit queries are drawn at random from the inserted birthdates, miss queries from dates outside the generator's pool.
+ */
+static void benchmarkOperations(long long rows, int dates, double skew)
+{
+    PersonGenerator generator(1, dates, skew);
+    vector<Person> people;
+    vector<string> keys, hits, misses;
+    people.reserve(rows);
+    keys.reserve(rows);
+    for (long long row = 0; row < rows; row++)
+    {
+        people.push_back(generator.nextPerson());
+        keys.push_back(people.back().getBirthday());
+    }
+    mt19937_64 random(7);
+    for (long long row = 0; row < rows; row++)
+    {
+        hits.push_back(keys[random() % rows]);
+        misses.push_back(PersonGenerator::missingDate(int(row)).formatDateToPrint());
+    }
+    long long checksum = 0;
+
+    {
+        HashTable<Person> table;
+        long long hitsFound = 0, missesFound = 0, removed = 0;
+        auto start = chrono::steady_clock::now();
+        for (long long row = 0; row < rows; row++)
+            table.insert(people[row], keys[row]);
+        report("HashTable insert", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : hits)
+            hitsFound += table.search(key) != -1;
+        report("HashTable search (hit)", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : misses)
+            missesFound += table.search(key) != -1;
+        report("HashTable search (miss)", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        table.reserve(table.getSize()); // room for twice as many entries, every node moved once
+        report("HashTable rehash", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : keys)
+            removed += table.remove(key);
+        report("HashTable remove", rows, rows, secondsSince(start));
+        if (hitsFound != rows || missesFound != 0 || removed != rows || table.getCount() != 0)
+            printf("%-34s %s\n", "HashTable results", verdict(false));
+    }
+    {
+        FlatHashTable<Person> flat;
+        long long hitsFound = 0, missesFound = 0, removed = 0;
+        auto start = chrono::steady_clock::now();
+        for (long long row = 0; row < rows; row++)
+            flat.insert(people[row], keys[row]);
+        report("FlatHashTable insert", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : hits)
+            hitsFound += flat.search(key) != -1;
+        report("FlatHashTable search (hit)", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : misses)
+            missesFound += flat.search(key) != -1;
+        report("FlatHashTable search (miss)", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : keys)
+            removed += flat.remove(key);
+        report("FlatHashTable remove", rows, rows, secondsSince(start));
+        if (hitsFound != rows || missesFound != 0 || removed != rows || flat.getCount() != 0)
+            printf("%-34s %s\n", "FlatHashTable results", verdict(false));
+    }
+    {
+        unordered_multimap<string, Person> baseline;
+        auto start = chrono::steady_clock::now();
+        for (long long row = 0; row < rows; row++)
+            baseline.emplace(keys[row], people[row]);
+        report("unordered_multimap insert", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : hits)
+            checksum += baseline.find(key) != baseline.end();
+        report("unordered_multimap find (hit)", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : misses)
+            checksum += baseline.find(key) != baseline.end();
+        report("unordered_multimap find (miss)", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : keys)
+            baseline.erase(baseline.find(key));
+        report("unordered_multimap erase", rows, rows, secondsSince(start));
+    }
+    {
+        HashMultiTable<Person> grouped;
+        auto start = chrono::steady_clock::now();
+        for (long long row = 0; row < rows; row++)
+            grouped.insert(people[row], keys[row]);
+        report("HashMultiTable insert", rows, rows, secondsSince(start));
+        start = chrono::steady_clock::now();
+        for (const string &key : hits)
+            checksum += grouped.countKey(key);
+        report("HashMultiTable equalRange (hit)", rows, rows, secondsSince(start));
+    }
+    {
+        const char *directory = getenv("TMPDIR");
+        string roster = string(directory ? directory : "/tmp") + "/lab6_benchmark_roster.txt";
+        PersonGenerator(1, dates, skew).writeRoster(roster, rows);
+        HashTableManager<Person> manager;
+        auto start = chrono::steady_clock::now();
+        manager.bulkLoad(roster);
+        report("HashTableManager bulkLoad", rows, rows, secondsSince(start));
+        remove(roster.c_str());
+    }
+    if (checksum == 42) // keeps the lookups from being optimized away
+        printf("\n");
+}
+
+/*
+ Compares lookups in large tables of distinct birthdate keys: HashTable, whose slots point to separately allocated nodes (a probe touches the slot array, then the node), FlatHashTable, which keeps entries inline next to one byte tags (a hit usually costs one miss into the tag group and one into the slot), and std::unordered_multimap.
+ Once the table is well past the size of the last level cache, most lookups pay for every miss in full, so ns/op roughly counts cache misses (about 80 - 100 ns each).
+ */
+static void benchmarkLargeTableLookups(int entries, int queries)
+{
+    vector<string> keys, hits, misses;
+    keys.reserve(entries);
+    for (int n = 0; n < entries; n++)
+        keys.push_back(dateKey(n));
+    mt19937 random(5);
+    for (int q = 0; q < queries; q++)
+    {
+        hits.push_back(keys[random() % entries]);
+        misses.push_back(PersonGenerator::missingDate(q).formatDateToPrint());
+    }
+    long long hashTableFound = 0, flatFound = 0, baselineFound = 0;
+    auto time = [&](const char *operation, auto lookup, const vector<string> &queryKeys, long long &found) {
+        auto start = chrono::steady_clock::now();
+        for (const string &key : queryKeys)
+            found += lookup(key);
+        report(operation, entries, queries, secondsSince(start));
+    };
+    {
+        HashTable<int> table;
+        for (int n = 0; n < entries; n++)
+            table.insert(n, keys[n]);
+        time("large HashTable (hit)", [&](const string &key) {return table.search(key) != -1;}, hits, hashTableFound);
+        time("large HashTable (miss)", [&](const string &key) {return table.search(key) != -1;}, misses, hashTableFound);
+    }
+    {
+        FlatHashTable<int> flat;
+        for (int n = 0; n < entries; n++)
+            flat.insert(n, keys[n]);
+        time("large FlatHashTable (hit)", [&](const string &key) {return flat.search(key) != -1;}, hits, flatFound);
+        time("large FlatHashTable (miss)", [&](const string &key) {return flat.search(key) != -1;}, misses, flatFound);
+    }
+    {
+        unordered_multimap<string, int> baseline;
+        for (int n = 0; n < entries; n++)
+            baseline.emplace(keys[n], n);
+        time("large unordered_multimap (hit)", [&](const string &key) {return baseline.find(key) != baseline.end();}, hits, baselineFound);
+        time("large unordered_multimap (miss)", [&](const string &key) {return baseline.find(key) != baseline.end();}, misses, baselineFound);
+    }
+    if (hashTableFound != queries || flatFound != queries || baselineFound != queries)
+        printf("%-34s %s\n", "large table results", verdict(false));
+}
+
+/*
+ Compares a loop of single search calls against searchBatch on the same random (hit) queries.
+ */
+static void benchmarkBatchSearch(int entries, int queries)
+{
+    HashTable<Person> table(entries * 2);
+    vector<string> keys;
+    keys.reserve(entries);
+    for (int n = 0; n < entries; n++)
+    {
+        keys.push_back(dateKey(n));
+        Date date;
+        date.parse(keys.back());
+        table.insert(Person("Person " + to_string(n), date), keys.back());
+    }
+    mt19937 random(42);
+    vector<string> queryKeys;
+    queryKeys.reserve(queries);
+    for (int q = 0; q < queries; q++)
+        queryKeys.push_back(keys[random() % entries]);
+
+    long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (const string &key : queryKeys)
+        checksum += table.search(key);
+    double single = secondsSince(start);
+
+    vector<int> results(queries);
+    start = chrono::steady_clock::now();
+    table.searchBatch(queryKeys.data(), queries, results.data());
+    double batch = secondsSince(start);
+    for (int result : results)
+        checksum -= result;
+
+    printf("%-28s %10d entries %8.1f ns/op single %8.1f ns/op batch %6.2fx%s\n", "search vs searchBatch", entries,
+           single * 1e9 / queries, batch * 1e9 / queries, single / batch, verdict(checksum == 0));
+}
+
+/*
+ Times building and then destroying a table of the given number of rows with each node allocator: every node from the heap, and nodes carved from NodeArena slabs.
+ */
+template <typename Allocator>
+static void benchmarkTeardown(const char *allocatorName, long long rows)
+{
+    PersonGenerator generator(1);
+    auto *table = new HashTable<Person, KeyHash, StringKeyPolicy, Allocator>();
+    auto start = chrono::steady_clock::now();
+    for (long long row = 0; row < rows; row++)
+    {
+        Person person = generator.nextPerson();
+        string key = person.getBirthday();
+        table->insert(move(person), move(key));
+    }
+    report((string("HashTable insert, ") + allocatorName).c_str(), rows, rows, secondsSince(start));
+    start = chrono::steady_clock::now();
+    delete table;
+    report((string("HashTable destroy, ") + allocatorName).c_str(), rows, rows, secondsSince(start));
+}
+
+/*
+ Times insert and search (hits and misses) on tables of distinct birthdate keys with each key policy: keys in a std::string in every node, and keys packed inline into 16 bytes.
+ */
+template <typename KeyPolicy>
+static void benchmarkKeyPolicy(const char *policyName, long long rows)
+{
+    vector<string> keys, hits, misses;
+    keys.reserve(rows);
+    for (long long row = 0; row < rows; row++)
+        keys.push_back(dateKey(int(row)));
+    mt19937_64 random(11);
+    for (long long row = 0; row < rows; row++)
+    {
+        hits.push_back(keys[random() % rows]);
+        misses.push_back(PersonGenerator::missingDate(int(row)).formatDateToPrint());
+    }
+    string name = policyName;
+    printf("%s: %zu bytes per node\n", policyName, sizeof(HashNode<Person, KeyPolicy>));
+    HashTable<Person, KeyHash, KeyPolicy> table;
+    auto start = chrono::steady_clock::now();
+    for (long long row = 0; row < rows; row++)
+    {
+        Date date;
+        date.parse(keys[row]);
+        table.emplace(keys[row], "Person", date);
+    }
+    report(("HashTable insert, " + name).c_str(), rows, rows, secondsSince(start));
+    long long checksum = 0;
+    start = chrono::steady_clock::now();
+    for (const string &key : hits)
+        checksum += table.search(key);
+    report(("HashTable search (hit), " + name).c_str(), rows, rows, secondsSince(start));
+    start = chrono::steady_clock::now();
+    for (const string &key : misses)
+        checksum += table.search(key);
+    report(("HashTable search (miss), " + name).c_str(), rows, rows, secondsSince(start));
+    if (checksum == 42)
+        printf("\n");
+}
+
+/*
+ Times every single insert while a table grows from its default size to the given number of rows, once with each resize mode, and reports the tail of the latency distribution.
+ A stop the world rehash lands entirely on the insert that triggers it, so it shows up in the highest percentiles and the maximum; an incremental resize spreads the same work over the inserts that follow.
+ */
+static void benchmarkResizeLatency(RESIZE_MODE mode, const char *modeName, long long rows)
+{
+    vector<string> keys;
+    keys.reserve(rows);
+    for (long long row = 0; row < rows; row++)
+        keys.push_back("key " + to_string(row));
+    vector<uint32_t> latencies(rows);
+    HashTable<int> table(20, 0.5, QUADRATIC_PROBING, mode);
+    auto start = chrono::steady_clock::now();
+    for (long long row = 0; row < rows; row++)
+    {
+        auto insertStart = chrono::steady_clock::now();
+        table.insert(int(row), keys[row]);
+        latencies[row] = uint32_t(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - insertStart).count());
+    }
+    double elapsed = secondsSince(start);
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double fraction) {return latencies[size_t(fraction * double(latencies.size() - 1))] / 1000.0;};
+    printf("%-28s %10lld rows %8.1f ns/op mean %8.2f us p99 %8.2f us p99.9 %8.2f us p99.99 %10.2f us max\n",
+           (string("insert latency, ") + modeName).c_str(), rows, elapsed * 1e9 / rows, percentile(0.99), percentile(0.999),
+           percentile(0.9999), latencies.back() / 1000.0);
+}
+
+/*
+ Checks that a table growing in the given resize mode still answers every lookup correctly, against a model of which keys should be present. Whenever a resize starts, and again partway through draining it, a sample of present keys is looked up (one at a time, which moves any found in the previous array across, and with searchBatch), a sample is removed (and removed again, which must fail), and keys never inserted must be missed. Only a sample is looked up at those points since every lookup drains a few previous slots itself, and looking up everything would finish the resize before most lookups reach the previous array. Every key is checked once all are inserted, and again after finishResize.
+ */
+static void checkResizeLookups(RESIZE_MODE mode, const char *modeName, long long rows)
+{
+    vector<string> keys, misses;
+    keys.reserve(rows);
+    for (long long row = 0; row < rows; row++)
+        keys.push_back("key " + to_string(row));
+    for (int miss = 0; miss < 256; miss++)
+        misses.push_back("missing " + to_string(miss));
+    vector<bool> present(rows, false);
+    HashTable<int> table(20, 0.5, QUADRATIC_PROBING, mode);
+    mt19937_64 random(11);
+    long long failures = 0, lookups = 0, checkpoints = 0, removed = 0;
+    auto found = [&](long long row, int index) {return index != -1 && table[index] == int(row);};
+    auto checkMisses = [&]()
+    {
+        for (const string &key : misses)
+            failures += table.search(key) != -1;
+        lookups += (long long)misses.size();
+    };
+    auto checkSample = [&](long long inserted) // looks up, batch looks up and removes a sample of the rows inserted so far
+    {
+        checkpoints++;
+        vector<long long> sample;
+        vector<string> sampleKeys;
+        for (int pick = 0; pick < 256; pick++)
+        {
+            long long row = (long long)(random() % (unsigned long long)inserted);
+            sample.push_back(row);
+            sampleKeys.push_back(keys[row]);
+        }
+        vector<int> batch = table.searchBatch(sampleKeys);
+        for (size_t i = 0; i < sample.size(); i++)
+            failures += present[sample[i]] ? !found(sample[i], batch[i]) : batch[i] != -1;
+        for (long long row : sample)
+        {
+            int index = table.search(keys[row]);
+            failures += present[row] ? !found(row, index) : index != -1;
+        }
+        for (size_t i = 0; i < sample.size(); i += 8)
+        {
+            long long row = sample[i];
+            failures += table.remove(keys[row]) != present[row];
+            failures += table.remove(keys[row]); // already gone
+            failures += table.search(keys[row]) != -1;
+            removed += present[row];
+            present[row] = false;
+        }
+        lookups += 2 * (long long)sample.size();
+        checkMisses();
+    };
+    auto checkAll = [&]()
+    {
+        vector<int> batch = table.searchBatch(keys);
+        for (long long row = 0; row < rows; row++)
+        {
+            failures += present[row] ? !found(row, batch[row]) : batch[row] != -1;
+            int index = table.search(keys[row]);
+            failures += present[row] ? !found(row, index) : index != -1;
+        }
+        lookups += 2 * rows;
+        checkMisses();
+        failures += table.getCount() != rows - removed;
+    };
+    bool resizing = false;
+    long long midway = -1; // row at which a resize that is still draining is checked again
+    for (long long row = 0; row < rows; row++)
+    {
+        table.insert(int(row), keys[row]);
+        present[row] = true;
+        if (table.isResizing() && !resizing) // a resize has just started
+        {
+            checkSample(row + 1);
+            midway = row + (row + 1) / 16;
+        }
+        else if (row == midway && table.isResizing())
+            checkSample(row + 1);
+        resizing = table.isResizing();
+    }
+    checkAll();
+    table.finishResize();
+    checkAll();
+    printf("%-28s %10lld rows %8lld checkpoints %10lld lookups %s\n", (string("resize checks, ") + modeName).c_str(), rows, checkpoints, lookups,
+           verdict(failures == 0 && !table.isResizing()));
+}
+
+/*
+ Compares parsing generated birthdates one at a time with Date::parse against DateParser's batch kernels. The dates sit in one buffer, one per line, the way bulkLoad sees them in a mapped file.
+ */
+static void benchmarkDateParsing(int dates)
+{
+    PersonGenerator generator(3);
+    string lines;
+    lines.reserve(size_t(dates) * (Date::FORMATTED_LENGTH + 1));
+    for (int n = 0; n < dates; n++)
+    {
+        lines += generator.nextDate().formatDateToPrint();
+        lines += '\n';
+    }
+    vector<string_view> fields;
+    fields.reserve(dates);
+    for (int n = 0; n < dates; n++)
+        fields.emplace_back(lines.data() + size_t(n) * (Date::FORMATTED_LENGTH + 1), Date::FORMATTED_LENGTH);
+
+    const int chunk = 4096; // same as bulkLoad
+    long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (string_view field : fields)
+    {
+        Date date;
+        date.parse(field);
+        checksum += date.getPacked();
+    }
+    double single = secondsSince(start);
+    printf("%-28s %10d dates %8.2f ns/date\n", "Date::parse", dates, single * 1e9 / dates);
+    vector<uint32_t> packed(chunk);
+    vector<int> invalid;
+    for (PARSE_KERNEL kernel : {SCALAR_KERNEL, SSE4_KERNEL, AVX2_KERNEL})
+    {
+        if (kernel > DateParser::bestKernel())
+            continue;
+        long long batchChecksum = 0;
+        start = chrono::steady_clock::now();
+        for (int first = 0; first < dates; first += chunk)
+        {
+            int count = dates - first < chunk ? dates - first : chunk;
+            DateParser::parseBatch(fields.data() + first, count, packed.data(), invalid, kernel);
+            for (int i = 0; i < count; i++)
+                batchChecksum += packed[i];
+        }
+        double batch = secondsSince(start);
+        printf("%-28s %10d dates %8.2f ns/date %6.2fx%s\n", (string("DateParser, ") + DateParser::kernelName(kernel)).c_str(), dates,
+               batch * 1e9 / dates, single / batch, verdict(batchChecksum == checksum && invalid.empty()));
+    }
+}
+
+/*
+ A FixedHashTable built from constant data is built and searched by the compiler. If any operation the table uses stops being constexpr, these static_asserts stop the build.
+ */
+static constexpr FixedHashTable<int, 16, 3> monthLengths = {
+    {"jan", 31}, {"feb", 28}, {"mar", 31}, {"apr", 30}, {"may", 31}, {"jun", 30},
+    {"jul", 31}, {"aug", 31}, {"sep", 30}, {"oct", 31}, {"nov", 30}, {"dec", 31}};
+static_assert(monthLengths.getCount() == 12, "every month inserted at compile time");
+static_assert(monthLengths[monthLengths.search("feb")] == 28 && monthLengths[monthLengths.search("sep")] == 30, "hits found at compile time");
+static_assert(monthLengths.search("xyz") == -1 && !monthLengths.contains("january"), "misses (and keys too long to insert) not found at compile time");
+
+/*
+ Compares HashTable against FixedHashTable on a small lookup table (256 date keys), the use FixedHashTable is meant for.
+ */
+static void benchmarkFixed(int queries)
+{
+    const int entries = 256;
+    HashTable<int> table(entries * 2);
+    FixedHashTable<int, 512, Date::FORMATTED_LENGTH> fixedTable;
+    vector<string> keys;
+    for (int n = 0; n < entries; n++)
+    {
+        keys.push_back(dateKey(n * 37));
+        table.insert(n, keys.back());
+        fixedTable.insert(n, keys.back());
+    }
+    mt19937 random(5);
+    vector<string> queryKeys;
+    queryKeys.reserve(queries);
+    for (int q = 0; q < queries; q++)
+        queryKeys.push_back(keys[random() % entries]);
+
+    long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (const string &key : queryKeys)
+        checksum += table[table.search(key)];
+    double dynamic = secondsSince(start);
+    start = chrono::steady_clock::now();
+    for (const string &key : queryKeys)
+        checksum -= fixedTable[fixedTable.search(key)];
+    double fixed = secondsSince(start);
+    printf("%-28s %10d entries %8.1f ns/op HashTable %8.1f ns/op FixedHashTable%s\n", "small table search", entries,
+           dynamic * 1e9 / queries, fixed * 1e9 / queries, verdict(checksum == 0));
+}
+
+/*
+ Sweeps every entry of a table (an aggregate of birth years, with a check that each entry's key matches its birthday) with a single range based for loop, then with the table's slots partitioned over the given number of threads.
+ */
+static void benchmarkSweep(long long rows, int threadCount)
+{
+    PersonGenerator generator(1);
+    HashTable<Person> table;
+    table.reserve(int(rows));
+    for (long long row = 0; row < rows; row++)
+    {
+        Person person = generator.nextPerson();
+        string key = person.getBirthday();
+        table.insert(move(person), move(key));
+    }
+    auto sweep = [](HashTable<Person>::iterator first, HashTable<Person>::iterator last, long long &years, long long &invalid) {
+        char formatted[Date::FORMATTED_LENGTH];
+        for (; first != last; ++first)
+        {
+            first->getDate().formatDateTo(formatted);
+            years += first->getDate().getYear();
+            invalid += first.key().compare(0, string::npos, formatted, Date::FORMATTED_LENGTH) != 0;
+        }
+    };
+
+    long long years = 0, invalid = 0;
+    auto start = chrono::steady_clock::now();
+    sweep(table.begin(), table.end(), years, invalid);
+    double serial = secondsSince(start);
+
+    vector<long long> partYears(threadCount, 0), partInvalid(threadCount, 0);
+    vector<HashTable<Person>::SlotRange> parts = table.partition(threadCount);
+    vector<thread> workers;
+    start = chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; t++)
+        workers.emplace_back([&, t]() {sweep(parts[t].begin(), parts[t].end(), partYears[t], partInvalid[t]);});
+    for (thread &worker : workers)
+        worker.join();
+    double parallel = secondsSince(start);
+    for (int t = 0; t < threadCount; t++)
+    {
+        years -= partYears[t];
+        invalid += partInvalid[t];
+    }
+    printf("%-28s %10lld entries %8.1f ns/entry serial %8.1f ns/entry on %d threads %6.2fx%s\n", "table sweep", rows,
+           serial * 1e9 / rows, parallel * 1e9 / rows, threadCount, serial / parallel,
+           verdict(years == 0 && invalid == 0));
+}
+
+/*
+ Runs a mix of searches, inserts and removes on one shared ConcurrentHashTable from the given number of threads: the given percentage of operations are searches, and the rest are split evenly between inserts and removes (ie. 90 gives 90/5/5, 100 only searches).
+ Before the clock starts, every other key of each thread's slice is inserted, so searches find about half their keys even when nothing else is going on.
+ Each thread works on its own slice of the key space and keeps a reference model of which of its keys should be present, so every result the table returns can be checked while other threads are hammering the same shards. Any mismatch is a failed check.
+ Returns the throughput in operations per second, and reports it against the given single thread throughput (if any) to show how the table scales.
+ */
+static double benchmarkConcurrent(int searchPercent, int threadCount, int keysPerThread, int operationsPerThread, double singleThreadRate)
+{
+    ConcurrentHashTable<int> table(256);
+    table.reserve(threadCount * keysPerThread);
+    vector<unordered_map<int, int>> models(threadCount); // per thread: key number -> value inserted
+    for (int t = 0; t < threadCount; t++)
+        for (int k = 0; k < keysPerThread; k += 2)
+        {
+            table.insert(k, dateKey(t * keysPerThread + k));
+            models[t][k] = k;
+        }
+    vector<long long> mismatches(threadCount, 0);
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; t++)
+    {
+        workers.emplace_back([&, t]() {
+            mt19937 random(t + 1);
+            unordered_map<int, int> &model = models[t];
+            vector<string> keys;
+            for (int k = 0; k < keysPerThread; k++)
+                keys.push_back(dateKey(t * keysPerThread + k));
+            int insertBelow = searchPercent + (100 - searchPercent) / 2; // rolls from searchPercent up to here insert, the rest remove
+            for (int op = 0; op < operationsPerThread; op++)
+            {
+                int k = int(random() % keysPerThread), roll = int(random() % 100);
+                auto expected = model.find(k);
+                if (roll < searchPercent)
+                {
+                    int found = -1;
+                    bool present = table.search(keys[k], found);
+                    if (present != (expected != model.end()) || (present && found != expected->second))
+                        mismatches[t]++;
+                }
+                else if (roll < insertBelow)
+                {
+                    if (expected == model.end())
+                    {
+                        table.insert(op, keys[k]);
+                        model[k] = op;
+                    }
+                }
+                else if (table.remove(keys[k]) != model.erase(k))
+                    mismatches[t]++;
+            }
+            for (auto &entry : model) // final state must match the model exactly
+                if (!table.contains(keys[entry.first]))
+                    mismatches[t]++;
+        });
+    }
+    for (thread &worker : workers)
+        worker.join();
+    double elapsed = secondsSince(start);
+    long long totalMismatches = 0;
+    for (long long m : mismatches)
+        totalMismatches += m;
+    if (totalMismatches > 0)
+        failedChecks++;
+    double operations = double(threadCount) * operationsPerThread;
+    double rate = operations / elapsed;
+    string name = "concurrent " + (searchPercent == 100 ? string("search only") : "mixed " + to_string(searchPercent) + "/" +
+                  to_string((100 - searchPercent) / 2) + "/" + to_string(100 - searchPercent - (100 - searchPercent) / 2));
+    printf("%-28s %10d threads %8.2f Mops/s %8.1f ns/op/thread", name.c_str(), threadCount, rate / 1e6, elapsed * 1e9 * threadCount / operations);
+    if (singleThreadRate > 0)
+        printf(" %6.2fx of 1 thread", rate / singleThreadRate);
+    if (totalMismatches > 0)
+        printf("  [%lld MISMATCHES]", totalMismatches);
+    printf("\n");
+    return rate;
+}
+
+int main(int argc, const char * argv[]) {
+    long long smallest = 1000, largest = 1000000;
+    int dates = 365 * 100;
+    double skew = 1;
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        if (strcmp(argv[arg], "--min") == 0)
+            smallest = atoll(argv[arg + 1]);
+        else if (strcmp(argv[arg], "--max") == 0)
+            largest = atoll(argv[arg + 1]);
+        else if (strcmp(argv[arg], "--dates") == 0)
+            dates = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "--skew") == 0)
+            skew = atof(argv[arg + 1]);
+    }
+    printf("%d distinct birthdates, skew %.2f\n", dates, skew);
+    for (long long rows = smallest; rows <= largest; rows *= 10)
+        benchmarkOperations(rows, dates, skew);
+    for (long long rows = smallest; rows <= largest; rows *= 10)
+    {
+        benchmarkTeardown<HeapNodeAllocator<Person>>("heap nodes", rows);
+        benchmarkTeardown<NodeArena<Person>>("node arena", rows);
+    }
+    for (long long rows = smallest; rows <= largest && rows <= 28 * 12 * 9000; rows *= 10)
+    {
+        benchmarkKeyPolicy<StringKeyPolicy>("strings", rows);
+        benchmarkKeyPolicy<PackedKeyPolicy>("packed", rows);
+    }
+    for (long long rows = smallest; rows <= largest; rows *= 10)
+    {
+        benchmarkResizeLatency(STOP_THE_WORLD_RESIZE, "stop the world", rows);
+        benchmarkResizeLatency(INCREMENTAL_RESIZE, "incremental", rows);
+    }
+    for (long long rows = smallest; rows <= largest; rows *= 10)
+    {
+        checkResizeLookups(STOP_THE_WORLD_RESIZE, "stop the world", rows);
+        checkResizeLookups(INCREMENTAL_RESIZE, "incremental", rows);
+    }
+    for (long long entries = smallest; entries <= largest && entries <= 28 * 12 * 9000; entries *= 10)
+        benchmarkBatchSearch(int(entries), 1000000);
+    benchmarkLargeTableLookups(int(largest < 2500000 ? largest : 2500000), 1000000); // dateKey reaches missingDate's years 9000+ past 2688000 entries
+    benchmarkFixed(10000000);
+    benchmarkDateParsing(int(largest < 10000000 ? largest : 10000000));
+    int cores = int(thread::hardware_concurrency());
+    benchmarkSweep(largest, cores < 2 ? 2 : cores);
+    if (cores < 2)
+        printf("only %d hardware thread, so the concurrent runs below check correctness but cannot show scaling\n", cores);
+    for (int searchPercent : {90, 100})
+    {
+        double singleThreadRate = 0;
+        for (int threads = 1; threads <= (cores > 32 ? 32 : (cores < 4 ? 4 : cores)); threads *= 2)
+        {
+            double rate = benchmarkConcurrent(searchPercent, threads, 50000, 1000000, singleThreadRate);
+            if (threads == 1)
+                singleThreadRate = rate;
+        }
+    }
+    if (failedChecks > 0)
+    {
+        fprintf(stderr, "%d benchmark result check(s) failed\n", failedChecks);
+        return 1;
+    }
+    return 0;
+}
@@ -5,13 +5,47 @@
 //  Created by Matan Broner on 11/26/18.
 //  Copyright © 2018 Matan Broner. All rights reserved.
 //
+//  Usage:
+//    lab6                                       interactive menu
+//    lab6 --batch <input file> [query file|-]   answers one date per line from the query file (or stdin)
+//    lab6 --snapshot <input file> <snapshot>    saves the loaded table as a snapshot, usable as --batch input
+//    lab6 --pipeline <feed|-> [query file|-]    ingests a live feed in the background while answering queries
+//
 
 #include <iostream>
+#include <string>
 #include "HashTableManager.h"
 
 using namespace std;
 int main(int argc, const char * argv[]) {
     HashTableManager<Person> manager;
+    if (argc > 1 && string(argv[1]) == "--batch")
+    {
+        if (argc < 3)
+        {
+            cerr << "usage: " << argv[0] << " --batch <input file> [query file|-]" << endl;
+            return 2;
+        }
+        return manager.runBatch(argv[2], argc > 3 ? argv[3] : "-");
+    }
+    if (argc > 1 && string(argv[1]) == "--snapshot")
+    {
+        if (argc < 4)
+        {
+            cerr << "usage: " << argv[0] << " --snapshot <input file> <snapshot file>" << endl;
+            return 2;
+        }
+        return manager.createSnapshot(argv[2], argv[3]);
+    }
+    if (argc > 1 && string(argv[1]) == "--pipeline")
+    {
+        if (argc < 3)
+        {
+            cerr << "usage: " << argv[0] << " --pipeline <feed|-> [query file|-]" << endl;
+            return 2;
+        }
+        return manager.runPipeline(argv[2], argc > 3 ? argv[3] : "-");
+    }
     manager.menu();
     
     return 0;